@@ -0,0 +1,131 @@
+/*******************************************************************************
+* File Name: acquire.c
+*
+* Description: This file finds the surface at power-on with single sensor
+*              scans in bisection order.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "acquire.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Wet sensors found, single sensor scans and time in us of the last acquisition */
+static uint8_t acquireWet = 0u;
+static uint8_t acquireScans = 0u;
+static uint32_t acquireUs = 0u;
+
+
+/*******************************************************************************
+* Function Name: acquire_run
+********************************************************************************
+* Summary:
+*  This function finds the level without a full scan. The wet sensors form a
+*  run from the bottom of the probe, so the first dry sensor is found by
+*  bisection: the sensor in the middle of the range still in question is
+*  scanned alone, and the range continues above it if it is wet and below it
+*  if it is dry. 12 sensors take at most 4 scans. The level is set as
+*  level_process_frame() would set it for that run; a droplet on a dry
+*  sensor or a dry film below the surface can mislead the search, which the
+*  first full frame corrects. It must be called while no scan is in
+*  progress, with the offsets and thresholds loaded.
+*
+* Return:
+*  Number of wet sensors.
+*
+*******************************************************************************/
+uint8_t acquire_run(void)
+{
+    uint8_t low = 0u;
+    uint8_t high = NUMSENSORS;
+    uint32_t start = hal_timer_ticks();
+
+    acquireScans = 0u;
+    while(low < high)
+    {
+        uint8_t middle = (uint8_t)((low + high) >> 1);
+
+        hal_sensor_scan_one_start(middle);
+        while(HAL_SENSOR_BUSY == hal_sensor_is_busy())
+        {
+        }
+        hal_sensor_process_one(middle);
+        acquireScans++;
+
+        if(TRUE == level_sensor_wet(middle))
+        {
+            low = middle + 1u;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    level_set_wet_run(low);
+    acquireWet = low;
+
+    acquireUs = (hal_timer_ticks() - start) / hal_timer_ticks_per_us();
+    return low;
+}
+
+/*******************************************************************************
+* Function Name: acquire_display
+********************************************************************************
+* Summary:
+*  This function displays the last acquisition, the wet sensors it found and
+*  the single sensor scans and time it took, then the level:
+*    Acquire=N/12 Scans=S TimeUs=T
+*
+*******************************************************************************/
+void acquire_display(void)
+{
+    hal_uart_put_string("Acquire=");
+    display_decimal_val(acquireWet, 0);
+    hal_uart_put_string("/");
+    display_decimal_val(NUMSENSORS, 0);
+    hal_uart_put_string(" Scans=");
+    display_decimal_val(acquireScans, 0);
+    hal_uart_put_string(" TimeUs=");
+    display_decimal_val((int32_t)acquireUs, 0);
+    hal_uart_put_string(" LevelMm=");
+    display_decimal_fixed_val(levelMm, 8, 1);
+    hal_uart_put_string("\r\n");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,296 @@
+/*******************************************************************************
+* File Name: alarm.c
+*
+* Description: This file contains the level alarms. Each alarm watches one
+*              sensor and drives one output. The alarms are evaluated in the
+*              CAPSENSE interrupt at the end of every scan, so that the outputs
+*              follow the liquid without waiting for the main loop.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "alarm.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Seed of the configuration checksum, so that erased storage is rejected */
+#define ALARM_CONFIG_CHECK      (0xA1A5u)
+
+/* The band must stay above zero processed counts */
+#define ALARM_HYSTERESIS_MAX    (SENSORLIMIT - 1u)
+
+/* Alarms that are active while their sensor is wet */
+#define ALARM_RISING_MASK       ((1u << ALARM_HH) | (1u << ALARM_H))
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint16_t alarm_config_check(const alarm_config_t *config);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Names used by the alarm command, in alarm order */
+const char * const alarmName[ALARM_COUNT] = {"hh", "h", "l", "ll"};
+
+/* Active configuration, the default one until a valid one is loaded */
+static alarm_config_t alarmConfig =
+{
+    {ALARM_HH_SENSOR_DEFAULT, ALARM_H_SENSOR_DEFAULT, ALARM_L_SENSOR_DEFAULT, ALARM_LL_SENSOR_DEFAULT},
+    ALARM_HYSTERESIS_DEFAULT, 0u, 0u
+};
+
+/* Bit n is set while alarm n is active. Written only in alarm_evaluate(). */
+static volatile uint8_t alarmState = 0u;
+
+
+/*******************************************************************************
+* Function Name: alarm_config_check
+********************************************************************************
+* Summary:
+*  This function computes the checksum of an alarm configuration.
+*
+*******************************************************************************/
+static uint16_t alarm_config_check(const alarm_config_t *config)
+{
+    uint16_t check = (uint16_t)(ALARM_CONFIG_CHECK + config->hysteresis);
+
+    for(uint8_t i = 0; i < ALARM_COUNT; i++)
+    {
+        check = (uint16_t)((check << 1) + config->sensor[i]);
+    }
+    return check;
+}
+
+/*******************************************************************************
+* Function Name: alarm_init
+********************************************************************************
+* Summary:
+*  This function loads the stored alarm configuration, or the default one,
+*  clears the outputs and hooks alarm_evaluate() to the end of every scan.
+*  Call it once the sensor driver is initialized.
+*
+*******************************************************************************/
+void alarm_init(void)
+{
+    alarm_config_t config;
+    uint32_t storage_status;
+    uint8_t valid;
+
+    storage_status = hal_storage_read(ALARM_CONFIG_START, &config, ALARM_CONFIG_SIZE);
+    handle_error(storage_status, "Emulated EEPROM Read failed \r\n");
+
+    valid = ((config.check == alarm_config_check(&config)) &&
+             (config.hysteresis <= ALARM_HYSTERESIS_MAX)) ? TRUE : FALSE;
+    for(uint8_t i = 0; i < ALARM_COUNT; i++)
+    {
+        if((config.sensor[i] >= NUMSENSORS) && (config.sensor[i] != ALARM_SENSOR_OFF))
+        {
+            valid = FALSE;
+        }
+    }
+    if(valid == TRUE)
+    {
+        alarmConfig = config;
+    }
+
+    alarmState = 0u;
+    hal_alarm_init();
+    hal_alarm_write(0u);
+    hal_sensor_set_scan_callback(alarm_evaluate);
+}
+
+/*******************************************************************************
+* Function Name: alarm_evaluate
+********************************************************************************
+* Summary:
+*  This function updates the alarms from the raw counts of the scan that has
+*  just completed and writes the outputs if any alarm changed. It runs in the
+*  CAPSENSE interrupt, so it reads only the setpoint sensors and leaves the
+*  rest of the frame to the main loop.
+*
+*  A sensor counts as wet above sensorLimit plus the hysteresis and as dry
+*  below sensorLimit minus the hysteresis. In between an alarm keeps its state.
+*
+*******************************************************************************/
+void alarm_evaluate(void)
+{
+    uint8_t state = alarmState;
+    int32_t high = (int32_t)sensorLimit + alarmConfig.hysteresis;
+    int32_t low = (int32_t)sensorLimit - alarmConfig.hysteresis;
+
+    for(uint8_t i = 0; i < ALARM_COUNT; i++)
+    {
+        uint8_t sensor = alarmConfig.sensor[i];
+        uint8_t bit = (uint8_t)(1u << i);
+        int32_t processed;
+
+        if(sensor >= NUMSENSORS)
+        {
+            state &= (uint8_t)~bit;
+            continue;
+        }
+
+        processed = (level_sensor_diff(sensor) * sensorScale[sensor]) >> 8;
+        if(processed > high)
+        {
+            /* Wet */
+            state = (0u != (bit & ALARM_RISING_MASK)) ? (state | bit) : (state & (uint8_t)~bit);
+        }
+        else if(processed < low)
+        {
+            /* Dry */
+            state = (0u != (bit & ALARM_RISING_MASK)) ? (state & (uint8_t)~bit) : (state | bit);
+        }
+    }
+
+    if(state != alarmState)
+    {
+        alarmState = state;
+        hal_alarm_write(state);
+    }
+}
+
+/*******************************************************************************
+* Function Name: alarm_get_state
+********************************************************************************
+* Summary:
+*  This function returns the active alarms, bit n for alarm n.
+*
+*******************************************************************************/
+uint8_t alarm_get_state(void)
+{
+    return alarmState;
+}
+
+/*******************************************************************************
+* Function Name: alarm_set_sensor
+********************************************************************************
+* Summary:
+*  This function moves the setpoint of an alarm to another sensor, or
+*  disables it with ALARM_SENSOR_OFF. The alarm is re-evaluated on the next
+*  scan. The change is kept until reset unless alarm_store() is called.
+*
+* Return:
+*  TRUE if the alarm and sensor are valid, FALSE otherwise.
+*
+*******************************************************************************/
+uint8_t alarm_set_sensor(uint8_t alarm, uint8_t sensor)
+{
+    if((alarm >= ALARM_COUNT) || ((sensor >= NUMSENSORS) && (sensor != ALARM_SENSOR_OFF)))
+    {
+        return FALSE;
+    }
+    /* A single byte store, so the interrupt sees the old or the new sensor */
+    alarmConfig.sensor[alarm] = sensor;
+    return TRUE;
+}
+
+/*******************************************************************************
+* Function Name: alarm_set_hysteresis
+********************************************************************************
+* Summary:
+*  This function sets the half width of the hysteresis band in processed
+*  counts.
+*
+* Return:
+*  TRUE if the hysteresis is valid, FALSE otherwise.
+*
+*******************************************************************************/
+uint8_t alarm_set_hysteresis(uint8_t hysteresis)
+{
+    if(hysteresis > ALARM_HYSTERESIS_MAX)
+    {
+        return FALSE;
+    }
+    alarmConfig.hysteresis = hysteresis;
+    return TRUE;
+}
+
+/*******************************************************************************
+* Function Name: alarm_store
+********************************************************************************
+* Summary:
+*  This function stores the active alarm configuration to emulated EEPROM.
+*
+*******************************************************************************/
+void alarm_store(void)
+{
+    uint32_t storage_status;
+
+    alarmConfig.reserved = 0u;
+    alarmConfig.check = alarm_config_check(&alarmConfig);
+
+    storage_status = hal_storage_write(ALARM_CONFIG_START, &alarmConfig, ALARM_CONFIG_SIZE);
+    handle_error(storage_status, "Emulated EEPROM Write failed \r\n");
+}
+
+/*******************************************************************************
+* Function Name: alarm_display
+********************************************************************************
+* Summary:
+*  This function displays the setpoint sensor and state of every alarm and
+*  the hysteresis in the UART terminal.
+*
+*******************************************************************************/
+void alarm_display(void)
+{
+    uint8_t state = alarmState;
+
+    for(uint8_t i = 0; i < ALARM_COUNT; i++)
+    {
+        hal_uart_put_string("Alarm ");
+        hal_uart_put_string(alarmName[i]);
+        if(alarmConfig.sensor[i] == ALARM_SENSOR_OFF)
+        {
+            hal_uart_put_string(": off");
+        }
+        else
+        {
+            hal_uart_put_string(": sensor ");
+            display_decimal_val(alarmConfig.sensor[i], 0);
+            hal_uart_put_string((0u != (state & (1u << i))) ? ", active" : ", clear");
+        }
+        hal_uart_put_string("\r\n");
+    }
+    hal_uart_put_string("AlarmHysteresis=");
+    display_decimal_val(alarmConfig.hysteresis, 0);
+    hal_uart_put_string("\r\n");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/*******************************************************************************
+* File Name: alarm.h
+*
+* Description: This file is the public interface of alarm.c source file.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef SOURCE_ALARM_H_
+#define SOURCE_ALARM_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Alarms, one output each. Bit n of the alarm state is alarm n. */
+#define ALARM_COUNT                 (4u)
+#define ALARM_HH                    (0u)    /* High-high, active while wet */
+#define ALARM_H                     (1u)    /* High, active while wet */
+#define ALARM_L                     (2u)    /* Low, active while dry */
+#define ALARM_LL                    (3u)    /* Low-low, active while dry */
+
+/* Sensor index of a disabled alarm */
+#define ALARM_SENSOR_OFF            (0xFFu)
+
+/* Default setpoint sensors and hysteresis in processed counts around
+ * sensorLimit. A sensor changes state once it is past the band.
+ */
+#define ALARM_HH_SENSOR_DEFAULT     (10u)
+#define ALARM_H_SENSOR_DEFAULT      (8u)
+#define ALARM_L_SENSOR_DEFAULT      (3u)
+#define ALARM_LL_SENSOR_DEFAULT     (1u)
+#define ALARM_HYSTERESIS_DEFAULT    (16u)
+
+/* Alarm configuration, stored after the sample table */
+#define ALARM_CONFIG_SIZE           (sizeof(alarm_config_t))
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Alarm configuration as stored in Emulated EEPROM */
+typedef struct
+{
+    uint8_t sensor[ALARM_COUNT];            /* Setpoint sensor, or ALARM_SENSOR_OFF */
+    uint8_t hysteresis;                     /* Half width of the band in processed counts */
+    uint8_t reserved;
+    uint16_t check;                         /* ALARM_CONFIG_CHECK plus the bytes above */
+} alarm_config_t;
+
+/*******************************************************************************
+* External variables
+*******************************************************************************/
+extern const char * const alarmName[ALARM_COUNT];
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void alarm_init(void);
+void alarm_evaluate(void);
+uint8_t alarm_get_state(void);
+uint8_t alarm_set_sensor(uint8_t alarm, uint8_t sensor);
+uint8_t alarm_set_hysteresis(uint8_t hysteresis);
+void alarm_store(void);
+void alarm_display(void);
+
+#endif /* SOURCE_ALARM_H_ */
+
+
+/* [] END OF FILE  */
@@ -0,0 +1,328 @@
+/*******************************************************************************
+* File Name: bench.c
+*
+* Description: This file contains the benchmark suite for the level pipeline
+*              and the UART formatting and command functions. It runs on the
+*              target and on the host and prints its results in CSV format.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "bench.h"
+#include "history.h"
+#include "alarm.h"
+#include "liquid.h"
+#include "tilt.h"
+#include "edge.h"
+#include "stats.h"
+
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Frames 0..NUMSENSORS have 0..NUMSENSORS sensors submerged from the bottom */
+#define BENCH_FRAMES        (NUMSENSORS + 1u)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef void (*bench_fn_t)(void);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void bench_nothing(void);
+static void bench_decimal_val(void);
+static void bench_decimal_fixed_val(void);
+static void bench_parse_command(void);
+static void bench_report_csv(void);
+static void bench_report_basic(void);
+static void bench_report_basic_lazy(void);
+static void load_frame(uint8_t frame);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Stages in the order they are reported */
+static const struct
+{
+    const char *name;
+    bench_fn_t fn;
+} stages[] =
+{
+    {"call_overhead",       bench_nothing},
+    {"scale_sensors",       level_scale_sensors},
+    {"count_submerged",     level_count_submerged},
+    {"compute_level",       level_compute},
+    {"count_mask",          level_count_mask},
+    {"lookup_level",        level_lookup},
+    {"process_frame",       level_process_frame},
+    {"process_frame_lazy",  level_process_frame_lazy},
+    {"tilt_estimate",       tilt_estimate},
+    {"edge_estimate",       edge_estimate},
+    {"history_frame",       history_process_frame},
+    {"alarm_evaluate",      alarm_evaluate},
+    {"stats_frame",         stats_process_frame},
+    {"liquid_frame",        liquid_process_frame},
+    {"report_csv",          bench_report_csv},
+    {"report_basic",        bench_report_basic},
+    {"report_basic_lazy",   bench_report_basic_lazy},
+    {"decimal_val",         bench_decimal_val},
+    {"decimal_fixed_val",   bench_decimal_fixed_val},
+    {"parse_command",       bench_parse_command},
+};
+
+
+/*******************************************************************************
+* Function Name: bench_run
+********************************************************************************
+* Summary:
+*  This function times every stage and prints one CSV row per stage:
+*    Stage,Iterations,Ticks,TicksPerIter,TicksPerUs,MaxTicksPerIter
+*  Each stage is called on every benchmark frame in turn. The pipeline state
+*  is set up untimed before each frame, and UART output is muted while timing
+*  so that only the CPU cost is measured. The fastest of BENCH_REPEATS runs is
+*  reported. MaxTicksPerIter is the slowest frame, each frame taken at its
+*  fastest repeat, as a measured estimate of the worst case execution time.
+*  The application state is restored afterwards and the level history and
+*  the noise statistics, which their stages fill, are cleared.
+*
+* Parameters:
+*    iterations    Total number of calls per stage.
+*
+*******************************************************************************/
+void bench_run(uint32_t iterations)
+{
+    const uint16_t *savedRaw;
+    uint8_t savedStride;
+    uint16_t savedOffset[NUMSENSORS];
+    uint8_t savedTxMode = uartTxMode;
+    uint8_t savedLazy = levelLazy;
+    uint32_t perFrame = iterations / BENCH_FRAMES;
+
+    if(perFrame == 0u)
+    {
+        perFrame = 1u;
+    }
+
+    level_get_raw_source(&savedRaw, &savedStride);
+    level_set_raw_source(sensorRaw, 1u);
+    memcpy(savedOffset, sensorEmptyOffset, sizeof(savedOffset));
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        sensorEmptyOffset[i] = BENCH_EMPTY_RAW;
+    }
+    level_update_thresholds();
+
+    hal_uart_put_string("Stage,Iterations,Ticks,TicksPerIter,TicksPerUs,MaxTicksPerIter\r\n");
+
+    for(uint8_t s = 0; s < sizeof(stages) / sizeof(stages[0]); s++)
+    {
+        uint32_t ticks = UINT32_MAX;
+        uint32_t frameTicks[BENCH_FRAMES];
+        uint32_t worst = 0u;
+
+        memset(frameTicks, 0xFF, sizeof(frameTicks));
+
+        for(uint8_t repeat = 0; repeat < BENCH_REPEATS; repeat++)
+        {
+            uint32_t total = 0u;
+            uint32_t start;
+
+            for(uint8_t frame = 0; frame < BENCH_FRAMES; frame++)
+            {
+                load_frame(frame);
+
+                hal_uart_mute(TRUE);
+                start = hal_timer_ticks();
+                for(uint32_t n = 0; n < perFrame; n++)
+                {
+                    stages[s].fn();
+                }
+                start = hal_timer_ticks() - start;
+                hal_uart_mute(FALSE);
+                total += start;
+                if(start < frameTicks[frame])
+                {
+                    frameTicks[frame] = start;
+                }
+            }
+            if(total < ticks)
+            {
+                ticks = total;
+            }
+        }
+        for(uint8_t frame = 0; frame < BENCH_FRAMES; frame++)
+        {
+            if(frameTicks[frame] > worst)
+            {
+                worst = frameTicks[frame];
+            }
+        }
+
+        hal_uart_put_string(stages[s].name);
+        hal_uart_put_string(",");
+        display_decimal_val((int32_t)(perFrame * BENCH_FRAMES), 0);
+        hal_uart_put_string(",");
+        display_decimal_val((int32_t)ticks, 0);
+        hal_uart_put_string(",");
+        display_decimal_val((int32_t)(ticks / (perFrame * BENCH_FRAMES)), 0);
+        hal_uart_put_string(",");
+        display_decimal_val((int32_t)hal_timer_ticks_per_us(), 0);
+        hal_uart_put_string(",");
+        display_decimal_val((int32_t)(worst / perFrame), 0);
+        hal_uart_put_string("\r\n");
+    }
+
+    /* Restore the application state */
+    level_set_raw_source(savedRaw, savedStride);
+    memcpy(sensorEmptyOffset, savedOffset, sizeof(savedOffset));
+    level_update_thresholds();
+    level_process_frame();
+    level_set_lazy(savedLazy, levelLazyBand);
+    history_clear();
+    stats_clear();
+    uartTxMode = savedTxMode;
+}
+
+/*******************************************************************************
+* Function Name: load_frame
+********************************************************************************
+* Summary:
+*  This function loads a synthetic frame with the given number of submerged
+*  sensors and runs the pipeline once so that every stage sees its input,
+*  the processed counts included.
+*
+*******************************************************************************/
+static void load_frame(uint8_t frame)
+{
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        sensorRaw[i] = (uint16_t)(BENCH_EMPTY_RAW + ((i < frame) ? BENCH_WET_DELTA : 0) + (i & 3));
+    }
+    level_process_frame();
+    level_scale_sensors();
+}
+
+/*******************************************************************************
+* Function Name: bench_nothing
+*******************************************************************************/
+static void bench_nothing(void)
+{
+}
+
+/*******************************************************************************
+* Function Name: bench_decimal_val
+*******************************************************************************/
+static void bench_decimal_val(void)
+{
+    display_decimal_val(sensorRaw[NUMSENSORS / 2u], 0);
+}
+
+/*******************************************************************************
+* Function Name: bench_decimal_fixed_val
+*******************************************************************************/
+static void bench_decimal_fixed_val(void)
+{
+    display_decimal_fixed_val(levelMm, 8, 1);
+}
+
+/*******************************************************************************
+* Function Name: bench_parse_command
+********************************************************************************
+* Summary:
+*  This function assembles and dispatches one "basic" command line.
+*
+*******************************************************************************/
+static void bench_parse_command(void)
+{
+    static const char command[] = "basic\r";
+
+    for(uint8_t i = 0; i < sizeof(command) - 1u; i++)
+    {
+        assemble_uart_cmd((uint8_t)command[i]);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bench_report_csv
+********************************************************************************
+* Summary:
+*  This function prints one csv mode report of the current frame, which is the
+*  longest report of the main loop.
+*
+*******************************************************************************/
+static void bench_report_csv(void)
+{
+    uartTxMode = UART_CSV;
+    display_cur_liquid_level();
+}
+
+/*******************************************************************************
+* Function Name: bench_report_basic
+********************************************************************************
+* Summary:
+*  This function prints one basic mode report of the current frame, formatted
+*  as every frame is outside lazy mode.
+*
+*******************************************************************************/
+static void bench_report_basic(void)
+{
+    uartTxMode = UART_BASIC;
+    levelLazy = FALSE;
+    display_cur_liquid_level();
+}
+
+/*******************************************************************************
+* Function Name: bench_report_basic_lazy
+********************************************************************************
+* Summary:
+*  This function prints one basic mode report of the current frame in lazy
+*  mode, where an unchanged level reuses the last formatted line.
+*
+*******************************************************************************/
+static void bench_report_basic_lazy(void)
+{
+    uartTxMode = UART_BASIC;
+    levelLazy = TRUE;
+    display_cur_liquid_level();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,82 @@
+/*******************************************************************************
+* File Name: crc.c
+*
+* Description: This file contains the CRC-16/CCITT-FALSE (polynomial 0x1021,
+*              initial value 0xFFFF) used to protect the level history download and
+*              the flash log rows.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "crc.h"
+
+
+/*******************************************************************************
+* Function Name: crc16_update
+********************************************************************************
+* Summary:
+*  This function adds one byte to a CRC. Bitwise, as the CRC is only used for
+*  downloads and flash rows, which are limited by the UART and the flash.
+*
+*******************************************************************************/
+uint16_t crc16_update(uint16_t crc, uint8_t data)
+{
+    crc ^= (uint16_t)data << 8;
+    for(uint8_t bit = 0; bit < 8u; bit++)
+    {
+        crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+/*******************************************************************************
+* Function Name: crc16_block
+********************************************************************************
+* Summary:
+*  This function adds a block of bytes to a CRC.
+*
+*******************************************************************************/
+uint16_t crc16_block(uint16_t crc, const void *data, uint32_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    while(size-- > 0u)
+    {
+        crc = crc16_update(crc, *bytes++);
+    }
+    return crc;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,435 @@
+/*******************************************************************************
+* File Name: datalog.c
+*
+* Description: This file contains the long-term level logger. The mean level of
+*              each period is delta encoded into a RAM row, and full rows are written to
+*              a circular area of flash rows next to the Emulated EEPROM. Every row is
+*              written once per turn of the circle, which levels the wear.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "datalog.h"
+#include "crc.h"
+
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DATALOG_PERIOD_MS   (DATALOG_PERIOD_S * 1000u)
+#define DATALOG_COUNT_MAX   (255u)
+
+/* A log row must fill exactly one flash row */
+typedef char datalog_row_check_t[(sizeof(datalog_row_t) == HAL_LOG_ROW_SIZE) ? 1 : -1];
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void datalog_add(int32_t level);
+static void datalog_write_row(void);
+static uint8_t datalog_read_row(uint32_t k, datalog_row_t *row);
+static uint32_t datalog_end_time(const datalog_row_t *row);
+static uint16_t datalog_row_crc(datalog_row_t *row);
+static void datalog_put_block(const void *data, uint32_t size);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static datalog_row_t logRow;            /* Row being filled */
+static uint8_t logUsed = 0;             /* Bytes used in logRow.data */
+static int32_t logLastLevel = 0;        /* Last record in 0.1 mm */
+static uint8_t logFlags = DATALOG_FLAG_BOOT;
+
+static uint32_t logNextRow = 0;         /* Flash row written next */
+static uint32_t logRowsUsed = 0;        /* Valid rows in flash */
+static uint32_t logSequence = 1;        /* Sequence of the next row */
+static uint32_t logTimeS = 0;           /* Log time of the next record */
+
+/* Mean of the current period */
+static uint32_t periodStartMs = 0;
+static int32_t periodSum = 0;
+static uint16_t periodFrames = 0;
+
+
+/*******************************************************************************
+* Function Name: datalog_init
+********************************************************************************
+* Summary:
+*  This function finds the newest row in flash and continues the log after
+*  it. Rows are valid if their CRC matches. As rows are written in a circle,
+*  the valid rows are the ones before the next row to write.
+*
+*******************************************************************************/
+void datalog_init(void)
+{
+    datalog_row_t row;
+    uint32_t newestSequence = 0;
+
+    logRowsUsed = 0;
+    for(uint32_t i = 0; i < HAL_LOG_ROWS; i++)
+    {
+        if((HAL_SUCCESS == hal_log_read(i, &row)) && (row.sequence != 0u) &&
+           (row.crc == datalog_row_crc(&row)))
+        {
+            logRowsUsed++;
+            if(row.sequence > newestSequence)
+            {
+                newestSequence = row.sequence;
+                logNextRow = (i + 1u) % HAL_LOG_ROWS;
+                logTimeS = datalog_end_time(&row) + row.periodS;
+            }
+        }
+    }
+    logSequence = newestSequence + 1u;
+    logRow.count = 0;
+    logFlags = DATALOG_FLAG_BOOT;
+    periodStartMs = hal_time_ms();
+}
+
+/*******************************************************************************
+* Function Name: datalog_process_frame
+********************************************************************************
+* Summary:
+*  This function adds the level of the frame just processed to the mean of
+*  the current period, and logs the mean when the period is over.
+*
+*******************************************************************************/
+void datalog_process_frame(void)
+{
+    int32_t mean;
+
+    periodSum += levelMm;
+    periodFrames++;
+
+    if((hal_time_ms() - periodStartMs) >= DATALOG_PERIOD_MS)
+    {
+        periodStartMs += DATALOG_PERIOD_MS;
+        /* 24.8 mm to 0.1 mm, rounded */
+        mean = periodSum / periodFrames;
+        mean = ((mean * 10) + 128) >> 8;
+        datalog_add((mean < 0) ? 0 : mean);
+        periodSum = 0;
+        periodFrames = 0;
+    }
+}
+
+/*******************************************************************************
+* Function Name: datalog_flush
+********************************************************************************
+* Summary:
+*  This function writes the row being filled to flash, so that its records
+*  survive a restart. Each flush uses up a row.
+*
+*******************************************************************************/
+void datalog_flush(void)
+{
+    if(logRow.count > 0u)
+    {
+        datalog_write_row();
+    }
+}
+
+/*******************************************************************************
+* Function Name: datalog_display_status
+********************************************************************************
+* Summary:
+*  This function prints the state of the log as
+*    Rows=n/N NextRow=r FirstS=t NextS=t Pending=n PeriodS=p
+*  FirstS is the log time of the oldest record, NextS of the next record and
+*  Pending the number of records not yet written to flash.
+*
+*******************************************************************************/
+void datalog_display_status(void)
+{
+    datalog_row_t row;
+    uint32_t firstS = logRow.startTimeS;
+
+    if(TRUE == datalog_read_row(0u, &row))
+    {
+        firstS = row.startTimeS;
+    }
+    else if(logRow.count == 0u)
+    {
+        firstS = logTimeS;
+    }
+
+    hal_uart_put_string("Rows=");
+    display_decimal_val((int32_t)logRowsUsed, 0);
+    hal_uart_put_string("/");
+    display_decimal_val(HAL_LOG_ROWS, 0);
+    hal_uart_put_string(" NextRow=");
+    display_decimal_val((int32_t)logNextRow, 0);
+    hal_uart_put_string(" FirstS=");
+    display_decimal_val((int32_t)firstS, 0);
+    hal_uart_put_string(" NextS=");
+    display_decimal_val((int32_t)logTimeS, 0);
+    hal_uart_put_string(" Pending=");
+    display_decimal_val(logRow.count, 0);
+    hal_uart_put_string(" PeriodS=");
+    display_decimal_val(DATALOG_PERIOD_S, 0);
+    hal_uart_put_string("\r\n");
+}
+
+/*******************************************************************************
+* Function Name: datalog_download
+********************************************************************************
+* Summary:
+*  This function sends the rows holding records from fromS to toS, including
+*  the row being filled, in the binary format described in datalog.h. The
+*  rows are found by binary search on their start times, so only the rows
+*  sent and about log2(HAL_LOG_ROWS) others are read.
+*
+* Parameters:
+*    fromS    Log time of the first record wanted.
+*    toS      Log time of the last record wanted.
+*
+*******************************************************************************/
+void datalog_download(uint32_t fromS, uint32_t toS)
+{
+    datalog_row_t row;
+    uint32_t first = 0;
+    uint32_t last = logRowsUsed;
+    uint32_t low;
+    uint32_t high;
+    uint32_t mid;
+    uint16_t rows;
+    uint8_t pending = FALSE;
+    uint8_t header[8] = {0};
+
+    /* First row that ends at or after fromS */
+    low = 0;
+    high = logRowsUsed;
+    while(low < high)
+    {
+        mid = (low + high) / 2u;
+        if((TRUE == datalog_read_row(mid, &row)) && (datalog_end_time(&row) < fromS))
+        {
+            low = mid + 1u;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    first = low;
+
+    /* First row that starts after toS */
+    high = logRowsUsed;
+    while(low < high)
+    {
+        mid = (low + high) / 2u;
+        if((TRUE == datalog_read_row(mid, &row)) && (row.startTimeS <= toS))
+        {
+            low = mid + 1u;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    last = low;
+
+    if((logRow.count > 0u) && (logRow.startTimeS <= toS) && (datalog_end_time(&logRow) >= fromS))
+    {
+        pending = TRUE;
+    }
+    rows = (uint16_t)((last - first) + pending);
+
+    memcpy(header, DATALOG_MAGIC, 4u);
+    header[4] = DATALOG_VERSION;
+    header[5] = HAL_LOG_ROW_SIZE;
+    header[6] = (uint8_t)rows;
+    header[7] = (uint8_t)(rows >> 8);
+    datalog_put_block(header, sizeof(header));
+
+    for(uint32_t k = first; k < last; k++)
+    {
+        if(TRUE == datalog_read_row(k, &row))
+        {
+            datalog_put_block(&row, sizeof(row));
+        }
+    }
+    if(TRUE == pending)
+    {
+        row = logRow;
+        row.crc = datalog_row_crc(&row);
+        datalog_put_block(&row, sizeof(row));
+    }
+}
+
+/*******************************************************************************
+* Function Name: datalog_add
+********************************************************************************
+* Summary:
+*  This function appends one record. A full row is written to flash and the
+*  record starts the next one.
+*
+*******************************************************************************/
+static void datalog_add(int32_t level)
+{
+    int32_t diff = level - logLastLevel;
+    uint32_t zigzag = ((uint32_t)diff << 1) ^ (uint32_t)(diff >> 31);
+    uint8_t size = (zigzag < 0x80u) ? 1u : 2u;
+
+    if((logRow.count > 0u) &&
+       (((logUsed + size) > DATALOG_DATA_SIZE) || (logRow.count >= DATALOG_COUNT_MAX)))
+    {
+        datalog_write_row();
+    }
+
+    if(logRow.count == 0u)
+    {
+        memset(&logRow, 0, sizeof(logRow));
+        logRow.sequence = logSequence;
+        logRow.startTimeS = logTimeS;
+        logRow.periodS = DATALOG_PERIOD_S;
+        logRow.firstLevel = (uint16_t)level;
+        logRow.flags = logFlags;
+        logFlags = 0;
+        logUsed = 0;
+    }
+    else if(size == 1u)
+    {
+        logRow.data[logUsed++] = (uint8_t)zigzag;
+    }
+    else
+    {
+        logRow.data[logUsed++] = (uint8_t)(0x80u | (zigzag >> 8));
+        logRow.data[logUsed++] = (uint8_t)zigzag;
+    }
+    logRow.count++;
+    logLastLevel = level;
+    logTimeS += DATALOG_PERIOD_S;
+}
+
+/*******************************************************************************
+* Function Name: datalog_write_row
+********************************************************************************
+* Summary:
+*  This function writes the row being filled to the next flash row of the
+*  circle and starts a new row.
+*
+*******************************************************************************/
+static void datalog_write_row(void)
+{
+    uint32_t storage_status;
+
+    logRow.crc = datalog_row_crc(&logRow);
+    storage_status = hal_log_write(logNextRow, &logRow);
+    handle_error(storage_status, "Log flash write failed \r\n");
+
+    logNextRow = (logNextRow + 1u) % HAL_LOG_ROWS;
+    if(logRowsUsed < HAL_LOG_ROWS)
+    {
+        logRowsUsed++;
+    }
+    logSequence++;
+    logRow.count = 0;
+}
+
+/*******************************************************************************
+* Function Name: datalog_read_row
+********************************************************************************
+* Summary:
+*  This function reads the k-th oldest row in flash.
+*
+* Return:
+*  TRUE if the row was read and is valid.
+*
+*******************************************************************************/
+static uint8_t datalog_read_row(uint32_t k, datalog_row_t *row)
+{
+    uint32_t index = (logNextRow + HAL_LOG_ROWS - logRowsUsed + k) % HAL_LOG_ROWS;
+
+    return ((k < logRowsUsed) && (HAL_SUCCESS == hal_log_read(index, row)) &&
+            (row->crc == datalog_row_crc(row))) ? TRUE : FALSE;
+}
+
+/*******************************************************************************
+* Function Name: datalog_end_time
+********************************************************************************
+* Summary:
+*  This function returns the log time of the last record of a row.
+*
+*******************************************************************************/
+static uint32_t datalog_end_time(const datalog_row_t *row)
+{
+    return row->startTimeS + ((uint32_t)(row->count - 1u) * row->periodS);
+}
+
+/*******************************************************************************
+* Function Name: datalog_row_crc
+********************************************************************************
+* Summary:
+*  This function returns the CRC of a row computed with its crc field zero.
+*
+*******************************************************************************/
+static uint16_t datalog_row_crc(datalog_row_t *row)
+{
+    uint16_t saved = row->crc;
+    uint16_t crc;
+
+    row->crc = 0;
+    crc = crc16_block(CRC16_INIT, row, sizeof(*row));
+    row->crc = saved;
+    return crc;
+}
+
+/*******************************************************************************
+* Function Name: datalog_put_block
+********************************************************************************
+* Summary:
+*  This function sends bytes, waiting for room in the UART FIFO.
+*
+*******************************************************************************/
+static void datalog_put_block(const void *data, uint32_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    while(size-- > 0u)
+    {
+        while(0UL == hal_uart_put(*bytes))
+        {
+
+        }
+        bytes++;
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,102 @@
+/*******************************************************************************
+* File Name: datalog.h
+*
+* Description: This file is the public interface of datalog.c source file.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef SOURCE_DATALOG_H_
+#define SOURCE_DATALOG_H_
+
+#include <stdint.h>
+#include "hal.h"
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* One record of the mean level is logged per period */
+#define DATALOG_PERIOD_S            (30u)
+
+/* Row header size and the record bytes that follow it */
+#define DATALOG_HEADER_SIZE         (16u)
+#define DATALOG_DATA_SIZE           (HAL_LOG_ROW_SIZE - DATALOG_HEADER_SIZE)
+
+/* Row flags */
+#define DATALOG_FLAG_BOOT           (0x01u)     /* First row after a restart */
+
+/* Binary download: magic, version, row size, row count (u16, little
+ * endian), then the rows oldest first exactly as stored.
+ */
+#define DATALOG_MAGIC               "LOGR"
+#define DATALOG_VERSION             (1u)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* One flash row. The first record is stored in full, each further record as
+ * the zigzag encoded difference to the one before in 0.1 mm:
+ *   0xxxxxxx            difference -64..63
+ *   1xxxxxxx xxxxxxxx   difference -16384..16383, high byte first
+ * Record n was taken at startTimeS + n * periodS. Log time is in seconds and
+ * continues across restarts from the end of the newest row.
+ */
+typedef struct
+{
+    uint32_t sequence;                      /* Write order, 0 if never written */
+    uint32_t startTimeS;                    /* Log time of the first record */
+    uint16_t periodS;
+    uint16_t firstLevel;                    /* 0.1 mm */
+    uint8_t count;                          /* Records in the row */
+    uint8_t flags;
+    uint16_t crc;                           /* CRC-16 of the row with crc = 0 */
+    uint8_t data[DATALOG_DATA_SIZE];
+} datalog_row_t;
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void datalog_init(void);
+void datalog_process_frame(void);
+void datalog_flush(void);
+void datalog_display_status(void);
+void datalog_download(uint32_t fromS, uint32_t toS);
+
+#endif /* SOURCE_DATALOG_H_ */
+
+
+/* [] END OF FILE  */
@@ -0,0 +1,166 @@
+/*******************************************************************************
+* File Name: edge.c
+*
+* Description: This file locates the surface at the largest rise between
+*              adjacent sensors.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "edge.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Largest rise from a sensor to the one below it, in processed counts */
+int32_t edgeRise = 0;
+/* Number of wet sensors from the bottom found at the edge */
+uint8_t edgeCount = 0u;
+/* TRUE to report the level at the edge */
+uint8_t edgeEnable = FALSE;
+/* TRUE while edge mode is enabled and edgeCount follows the frames */
+static uint8_t edgeTracking = FALSE;
+
+
+/*******************************************************************************
+* Function Name: edge_estimate
+********************************************************************************
+* Summary:
+*  This function locates the surface from the differences of adjacent
+*  sensors instead of the level of each sensor. The surface lies where the
+*  processed count drops the most from one sensor to the one above it, so an
+*  offset shared by all sensors, from grounding, a hand nearby or EMI,
+*  cancels out. A sensor covered halfway drops by the same amount to both
+*  neighbours and counts as dry, where the threshold takes it as wet above
+*  sensorLimit. If no drop exceeds half of sensorLimit the probe is empty
+*  or full, and the mean of all sensors against sensorLimit tells which.
+*  The processed counts are computed if the frame has not needed them yet.
+*
+*******************************************************************************/
+void edge_estimate(void)
+{
+    int32_t best = 0;
+    uint8_t count = 0u;
+
+    level_require_processed();
+    for(uint8_t i = 0; i < (NUMSENSORS - 1u); i++)
+    {
+        int32_t rise = (int32_t)sensorProcessed[i] - sensorProcessed[i + 1u];
+
+        if(rise > best)
+        {
+            best = rise;
+            count = i + 1u;
+        }
+    }
+
+    if(best <= (sensorLimit >> 1))
+    {
+        int32_t sum = 0;
+
+        for(uint8_t i = 0; i < NUMSENSORS; i++)
+        {
+            sum += sensorProcessed[i];
+        }
+        count = (sum > ((int32_t)sensorLimit * (int32_t)NUMSENSORS)) ? NUMSENSORS : 0u;
+    }
+
+    edgeRise = best;
+    edgeCount = count;
+}
+
+/*******************************************************************************
+* Function Name: edge_process_frame
+********************************************************************************
+* Summary:
+*  This function replaces sensorActiveCount, levelMm and levelPercent by the
+*  level at the edge when edge mode is enabled. The edge is kept for a frame
+*  in which lazy mode found no sensor changed. The cost is a subtraction and
+*  a compare per sensor on top of the scaling.
+*
+*******************************************************************************/
+void edge_process_frame(void)
+{
+    if(edgeEnable == TRUE)
+    {
+        if((levelFrameChanged == TRUE) || (edgeTracking == FALSE))
+        {
+            edge_estimate();
+            edgeTracking = TRUE;
+        }
+        level_set_run(edgeCount);
+    }
+    else
+    {
+        edgeTracking = FALSE;
+    }
+}
+
+/*******************************************************************************
+* Function Name: edge_display
+********************************************************************************
+* Summary:
+*  This function displays whether the level is taken at the edge, the wet
+*  sensors found there, the rise at the edge and the wet sensors found by
+*  the threshold.
+*
+*******************************************************************************/
+void edge_display(void)
+{
+    uint8_t wet = 0u;
+
+    if(edgeEnable == FALSE)
+    {
+        edge_estimate();
+    }
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        wet += (uint8_t)((levelWetMask >> i) & 1u);
+    }
+
+    hal_uart_put_string("Edge=");
+    hal_uart_put_string((edgeEnable == TRUE) ? "on" : "off");
+    hal_uart_put_string(" Wet=");
+    display_decimal_val(edgeCount, 0);
+    hal_uart_put_string(" Rise=");
+    display_decimal_val(edgeRise, 0);
+    hal_uart_put_string(" ThresholdWet=");
+    display_decimal_val(wet, 0);
+    hal_uart_put_string("\r\n");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,142 @@
+/*******************************************************************************
+* File Name: hal.h
+*
+* Description: This file is the hardware abstraction layer used by the liquid
+*              level application. It is implemented by hal_psoc4.c on the target
+*              and by host/hal_posix.c on a Linux workstation.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef SOURCE_HAL_H_
+#define SOURCE_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* HAL status codes */
+#define HAL_SUCCESS                 (0u)
+#define HAL_ERROR                   (1u)
+
+/* Logical storage size in bytes that every backend provides at least */
+#define HAL_STORAGE_SIZE            (256u)
+
+/* Log storage: flash rows reserved next to the Emulated EEPROM, written one
+ * whole row at a time. A row that has never been written reads as zeros.
+ */
+#define HAL_LOG_ROW_SIZE            (128u)
+#define HAL_LOG_ROWS                (256u)
+
+/* Number of alarm outputs driven by hal_alarm_write(), bit 0 first */
+#define HAL_ALARM_OUTPUTS           (4u)
+
+/* Return values of hal_sensor_self_test() */
+#define HAL_SELFTEST_PASS           (0u)
+#define HAL_SELFTEST_SHORT          (1u)    /* Pin shorted to a supply or another pin */
+#define HAL_SELFTEST_ERROR          (2u)    /* Test not available or not completed */
+
+/* Return values of hal_sensor_is_busy() */
+#define HAL_SENSOR_NOT_BUSY         (0u)
+#define HAL_SENSOR_BUSY             (1u)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Called in interrupt context when a scan completes */
+typedef void (*hal_callback_t)(void);
+
+/* Read-only view of the raw counts kept by the sensor driver. The raw count
+ * of sensor i is raw[i * stride]. It is stable from scan completion until
+ * the next hal_sensor_scan_start().
+ */
+typedef struct
+{
+    const uint16_t *raw;
+    uint8_t stride;                           /* In uint16_t elements */
+} hal_sensor_view_t;
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+/* Board */
+void hal_init(void);
+void hal_halt(void);
+
+/* Sensor frame acquisition */
+uint32_t hal_sensor_init(void);
+uint32_t hal_sensor_self_test(uint8_t sensor, uint32_t *capFf);
+void hal_sensor_scan_start(void);
+void hal_sensor_scan_one_start(uint8_t sensor);
+uint8_t hal_sensor_is_busy(void);
+void hal_sensor_process(void);
+void hal_sensor_process_one(uint8_t sensor);
+hal_sensor_view_t hal_sensor_get_view(void);
+void hal_sensor_set_scan_callback(hal_callback_t callback);
+
+/* Alarm outputs */
+void hal_alarm_init(void);
+void hal_alarm_write(uint8_t outputs);
+
+/* Serial I/O */
+uint32_t hal_uart_put(uint32_t data);
+void hal_uart_put_string(const char *string);
+uint32_t hal_uart_get_num_in_rx(void);
+uint32_t hal_uart_get(void);
+void hal_uart_mute(uint8_t mute);
+
+/* Persistent storage */
+uint32_t hal_storage_init(void);
+uint32_t hal_storage_read(uint32_t addr, void *data, uint32_t size);
+uint32_t hal_storage_write(uint32_t addr, const void *data, uint32_t size);
+
+/* Log storage */
+uint32_t hal_log_read(uint32_t row, void *data);
+uint32_t hal_log_write(uint32_t row, const void *data);
+
+/* Time */
+void hal_delay_ms(uint32_t ms);
+uint32_t hal_time_ms(void);
+uint32_t hal_timer_ticks(void);
+uint32_t hal_timer_ticks_per_us(void);
+
+#endif /* SOURCE_HAL_H_ */
+
+
+/* [] END OF FILE  */
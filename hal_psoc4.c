@@ -0,0 +1,817 @@
+/*******************************************************************************
+* File Name: hal_psoc4.c
+*
+* Description: This file implements the hardware abstraction layer on PSoC 4
+*              using the CAPSENSE middleware, the SCB UART driver and the
+*              Emulated EEPROM middleware.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "cycfg.h"
+#include "cycfg_capsense.h"
+#include "cy_em_eeprom.h"
+#include "hal.h"
+#include "sensor_table.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define CAPSENSE_INTR_PRIORITY    (3u)
+#define CY_ASSERT_FAILED          (0u)
+
+/* EZI2C interrupt priority must be higher than CAPSENSE interrupt. */
+#define EZI2C_INTR_PRIORITY       (2u)
+
+/* Enable this, if Tuner needs to be enabled */
+#define CAPSENSE_TUNER_EN                            (0u)
+
+/* Alarm outputs, active high, on Arduino header pins that the design leaves
+ * unused: D10 (P5.3) HH, D11 (P5.0) H, D12 (P5.1) L and D13 (P5.2) LL.
+ */
+#define ALARM0_PORT               (P5_3_PORT)
+#define ALARM0_PIN                (P5_3_NUM)
+#define ALARM1_PORT               (P5_0_PORT)
+#define ALARM1_PIN                (P5_0_NUM)
+#define ALARM2_PORT               (P5_1_PORT)
+#define ALARM2_PIN                (P5_1_NUM)
+#define ALARM3_PORT               (P5_2_PORT)
+#define ALARM3_PIN                (P5_2_NUM)
+
+/* SysTick is used as a 1 ms time base */
+#define SYSTICK_CALLBACK_SLOT     (0u)
+#define TICKS_PER_MS              (SystemCoreClock / 1000u)
+
+/* Emulated EEPROM Configuration details. All the sizes mentioned are in bytes.
+ * For details on how to configure these values refer to cy_em_eeprom.h. The
+ * middleware documentation is provided in Emulated EEPROM API Reference Manual.
+ * The user can access it from the Documentation section in the Quick Panel.
+ */
+/* HAL_STORAGE_SIZE rounded up to whole flash rows */
+#define EM_EEPROM_SIZE              (((HAL_STORAGE_SIZE + CY_EM_EEPROM_FLASH_SIZEOF_ROW - 1u) / \
+                                      CY_EM_EEPROM_FLASH_SIZEOF_ROW) * CY_EM_EEPROM_FLASH_SIZEOF_ROW)
+#define BLOCKING_WRITE              (1u)
+#define REDUNDANT_COPY              (1u)
+#define WEAR_LEVELLING_FACTOR       (2u)
+#define SIMPLE_MODE                 (0u)
+
+#define EM_EEPROM_PHYSICAL_SIZE     (CY_EM_EEPROM_GET_PHYSICAL_SIZE(EM_EEPROM_SIZE, SIMPLE_MODE, WEAR_LEVELLING_FACTOR, REDUNDANT_COPY))
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Emulated EEPROM configuration and context structure. */
+cy_stc_eeprom_config_t em_eeprom_config =
+{
+    .eepromSize         = EM_EEPROM_SIZE,           /* 256 bytes or more */
+    .blockingWrite      = BLOCKING_WRITE,           /* Blocking writes enabled */
+    .redundantCopy      = REDUNDANT_COPY,           /* Redundant copy enabled */
+    .wearLevelingFactor = WEAR_LEVELLING_FACTOR,    /* Wear levelling factor of 2 */
+    .simpleMode         = SIMPLE_MODE,              /* Simple mode disabled */
+};
+
+/* sensor_table.c is generated from the same design as cycfg_capsense.h */
+#if (CY_CAPSENSE_WIDGET_COUNT != SENSOR_COUNT)
+#error "sensor_table.c is out of date, run make -C host gen"
+#endif
+
+/* Flash area reserved for the Emulated EEPROM */
+CY_ALIGN(CY_EM_EEPROM_FLASH_SIZEOF_ROW)
+const uint8_t eepromEmptyOffset[EM_EEPROM_PHYSICAL_SIZE] = {0u};
+
+/* Flash area reserved for the level log. Each log row is one flash row. */
+#if (CY_FLASH_SIZEOF_ROW != HAL_LOG_ROW_SIZE)
+#error "HAL_LOG_ROW_SIZE must match the flash row size"
+#endif
+CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+const uint8_t logFlash[HAL_LOG_ROWS * HAL_LOG_ROW_SIZE] = {0u};
+
+/* Set while UART output is discarded */
+static uint8_t uartMuted = 0u;
+
+/* Called from the CAPSENSE interrupt at the end of every scan */
+static volatile hal_callback_t scanCallback = NULL;
+/* Set while a single sensor is scanned, which does not call scanCallback */
+static volatile uint8_t scanOne = 0u;
+
+/* Alarm output pins, bit 0 of hal_alarm_write() first */
+static GPIO_PRT_Type * const alarmPort[HAL_ALARM_OUTPUTS] = {ALARM0_PORT, ALARM1_PORT, ALARM2_PORT, ALARM3_PORT};
+static const uint8_t alarmPin[HAL_ALARM_OUTPUTS] = {ALARM0_PIN, ALARM1_PIN, ALARM2_PIN, ALARM3_PIN};
+
+/* Milliseconds elapsed since hal_init(), incremented from SysTick */
+static volatile uint32_t timeMs = 0u;
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+cy_stc_scb_uart_context_t CYBSP_UART_context;
+cy_stc_scb_ezi2c_context_t ezi2c_context;
+cy_stc_eeprom_context_t em_eeprom_context;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void capsense_isr(void);
+static void capsense_end_of_scan(cy_stc_capsense_active_scan_sns_t *ptrActiveScan);
+static void systick_callback(void);
+
+#if CAPSENSE_TUNER_EN
+static void ezi2c_isr(void);
+static void initialize_capsense_tuner(void);
+#endif
+
+
+/*******************************************************************************
+* Function Name: hal_init
+********************************************************************************
+* Summary:
+*  This function initializes the device and board peripherals, the UART and the
+*  SysTick time base, and enables global interrupts.
+*
+*******************************************************************************/
+void hal_init(void)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    /* Initialize the device and board peripherals */
+    result = cybsp_init();
+
+    /* Board init failed. Stop program execution */
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(CY_ASSERT_FAILED);
+    }
+
+    /* Configure and enable the UART peripheral */
+    Cy_SCB_UART_Init(CYBSP_UART_HW, &CYBSP_UART_config, &CYBSP_UART_context);
+    Cy_SCB_UART_Enable(CYBSP_UART_HW);
+
+    /* Configure a 1 ms SysTick for hal_time_ms() and hal_timer_ticks() */
+    Cy_SysTick_Init(CY_SYSTICK_CLOCK_SOURCE_CLK_CPU, TICKS_PER_MS - 1u);
+    Cy_SysTick_SetCallback(SYSTICK_CALLBACK_SLOT, systick_callback);
+
+    /* Enable global interrupts */
+    __enable_irq();
+}
+
+/*******************************************************************************
+* Function Name: hal_halt
+********************************************************************************
+* Summary:
+*  This function disables interrupts and stops program execution.
+*
+*******************************************************************************/
+void hal_halt(void)
+{
+    __disable_irq();
+    while(1u);
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_init
+********************************************************************************
+* Summary:
+*  This function initializes the CAPSENSE and configures the CAPSENSE
+*  interrupt. If the tuner is enabled, the EZI2C interface is initialized first.
+*
+* Return:
+*  HAL_SUCCESS or HAL_ERROR.
+*
+*******************************************************************************/
+uint32_t hal_sensor_init(void)
+{
+    cy_capsense_status_t status = CY_CAPSENSE_STATUS_SUCCESS;
+
+    /* CAPSENSE interrupt configuration */
+    const cy_stc_sysint_t capsense_interrupt_config =
+    {
+        .intrSrc = CYBSP_CAPSENSE_IRQ,
+        .intrPriority = CAPSENSE_INTR_PRIORITY,
+    };
+
+#if CAPSENSE_TUNER_EN
+    /* Initialize EZI2C */
+    initialize_capsense_tuner();
+#endif
+
+    /* Capture the CSD HW block and initialize it to the default state. */
+    status = Cy_CapSense_Init(&cy_capsense_context);
+
+    if (CY_CAPSENSE_STATUS_SUCCESS == status)
+    {
+        /* Initialize CAPSENSE interrupt */
+        Cy_SysInt_Init(&capsense_interrupt_config, capsense_isr);
+        NVIC_ClearPendingIRQ(capsense_interrupt_config.intrSrc);
+        NVIC_EnableIRQ(capsense_interrupt_config.intrSrc);
+
+        /* Forward the end of every scan to hal_sensor_set_scan_callback() */
+        (void)Cy_CapSense_RegisterCallback(CY_CAPSENSE_END_OF_SCAN_E, capsense_end_of_scan,
+                                           &cy_capsense_context);
+
+        /* Initialize the CAPSENSE firmware modules. */
+        status = Cy_CapSense_Enable(&cy_capsense_context);
+    }
+
+    /* This status could fail before tuning the sensors correctly.
+     * Ensure that this function passes after the CAPSENSE sensors are tuned
+     * as per procedure give in the Readme.md file */
+    return (CY_CAPSENSE_STATUS_SUCCESS == status) ? HAL_SUCCESS : HAL_ERROR;
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_self_test
+********************************************************************************
+* Summary:
+*  This function runs the CAPSENSE built-in self-test of one sensor: the pin
+*  short check, then the electrode capacitance measurement. It must be called
+*  after hal_sensor_init() while no scan is in progress; the next scan
+*  restores the sensing configuration.
+*
+* Parameters:
+*    sensor    Sensor index, 0 to SENSOR_COUNT - 1.
+*    capFf     Receives the sensor capacitance in fF, 0 if not measured.
+*
+* Return:
+*  HAL_SELFTEST_PASS, HAL_SELFTEST_SHORT or HAL_SELFTEST_ERROR.
+*
+*******************************************************************************/
+uint32_t hal_sensor_self_test(uint8_t sensor, uint32_t *capFf)
+{
+    *capFf = 0u;
+#if (CY_CAPSENSE_BIST_EN)
+    cy_en_capsense_bist_status_t status;
+
+    /* Every widget has one sensor */
+    status = Cy_CapSense_CheckIntegritySensorPins(sensorWidgetId[sensor], 0u, &cy_capsense_context);
+    if(CY_CAPSENSE_BIST_FAIL_E == status)
+    {
+        return HAL_SELFTEST_SHORT;
+    }
+    if(CY_CAPSENSE_BIST_SUCCESS_E == status)
+    {
+        status = Cy_CapSense_MeasureCapacitanceSensor(sensorWidgetId[sensor], 0u, capFf,
+                                                      &cy_capsense_context);
+    }
+    return (CY_CAPSENSE_BIST_SUCCESS_E == status) ? HAL_SELFTEST_PASS : HAL_SELFTEST_ERROR;
+#else
+    /* Self-test is disabled in the CAPSENSE configuration (BIST_EN) */
+    (void)sensor;
+    return HAL_SELFTEST_ERROR;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_scan_start
+********************************************************************************
+* Summary:
+*  This function starts a scan of all widgets. If the tuner is enabled, it
+*  synchronizes with the CAPSENSE Tuner tool before the scan is started.
+*
+*******************************************************************************/
+void hal_sensor_scan_start(void)
+{
+#if CAPSENSE_TUNER_EN
+    /* Establishes synchronized communication with the CapSense Tuner tool */
+    Cy_CapSense_RunTuner(&cy_capsense_context);
+#endif
+    scanOne = 0u;
+    Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_scan_one_start
+********************************************************************************
+* Summary:
+*  This function starts a scan of the widget of one sensor. The raw counts
+*  of the other sensors are left as they are, and the scan callback is not
+*  called for it.
+*
+* Parameters:
+*    sensor    Sensor index, 0 to SENSOR_COUNT - 1.
+*
+*******************************************************************************/
+void hal_sensor_scan_one_start(uint8_t sensor)
+{
+    scanOne = 1u;
+    (void)Cy_CapSense_ScanWidget(sensorWidgetId[sensor], &cy_capsense_context);
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_is_busy
+********************************************************************************
+* Summary:
+*  This function returns HAL_SENSOR_BUSY while a scan is in progress.
+*
+*******************************************************************************/
+uint8_t hal_sensor_is_busy(void)
+{
+    return (CY_CAPSENSE_NOT_BUSY == Cy_CapSense_IsBusy(&cy_capsense_context)) ?
+           HAL_SENSOR_NOT_BUSY : HAL_SENSOR_BUSY;
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_process
+********************************************************************************
+* Summary:
+*  This function processes all widgets of the completed scan.
+*
+*******************************************************************************/
+void hal_sensor_process(void)
+{
+    Cy_CapSense_ProcessAllWidgets(&cy_capsense_context);
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_process_one
+********************************************************************************
+* Summary:
+*  This function processes the widget of one sensor after its scan.
+*
+*******************************************************************************/
+void hal_sensor_process_one(uint8_t sensor)
+{
+    (void)Cy_CapSense_ProcessWidget(sensorWidgetId[sensor], &cy_capsense_context);
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_get_view
+********************************************************************************
+* Summary:
+*  This function returns a view of the raw counts in the CAPSENSE middleware
+*  sensor context, so that they are read in place. Every widget has one
+*  sensor and the configurator places their contexts in one array in widget
+*  order, which is checked against sensorWidgetId[] in debug builds.
+*
+*******************************************************************************/
+hal_sensor_view_t hal_sensor_get_view(void)
+{
+    const cy_stc_capsense_sensor_context_t *sensorContext =
+        cy_capsense_context.ptrWdConfig[sensorWidgetId[0u]].ptrSnsContext;
+    hal_sensor_view_t view;
+
+    for(uint32_t i = 0u; i < SENSOR_COUNT; i++)
+    {
+        CY_ASSERT(cy_capsense_context.ptrWdConfig[sensorWidgetId[i]].ptrSnsContext == &sensorContext[i]);
+    }
+
+    view.raw = &sensorContext[0u].raw;
+    view.stride = (uint8_t)(sizeof(cy_stc_capsense_sensor_context_t) / sizeof(uint16_t));
+    return view;
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_set_scan_callback
+********************************************************************************
+* Summary:
+*  This function sets the function called from the CAPSENSE interrupt once
+*  all widgets have been scanned, before the main loop sees the scan complete.
+*  Passing NULL removes it.
+*
+*******************************************************************************/
+void hal_sensor_set_scan_callback(hal_callback_t callback)
+{
+    scanCallback = callback;
+}
+
+/*******************************************************************************
+* Function Name: hal_alarm_init
+********************************************************************************
+* Summary:
+*  This function configures the alarm pins as strong drive outputs, low.
+*
+*******************************************************************************/
+void hal_alarm_init(void)
+{
+    for(uint32_t i = 0u; i < HAL_ALARM_OUTPUTS; i++)
+    {
+        Cy_GPIO_Pin_FastInit(alarmPort[i], alarmPin[i], CY_GPIO_DM_STRONG_IN_OFF, 0u, HSIOM_SEL_GPIO);
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_alarm_write
+********************************************************************************
+* Summary:
+*  This function drives the alarm pins, bit n of outputs to pin n. It is
+*  called from the CAPSENSE interrupt.
+*
+*******************************************************************************/
+void hal_alarm_write(uint8_t outputs)
+{
+    for(uint32_t i = 0u; i < HAL_ALARM_OUTPUTS; i++)
+    {
+        Cy_GPIO_Write(alarmPort[i], alarmPin[i], (outputs >> i) & 1u);
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_uart_put
+********************************************************************************
+* Summary:
+*  This function places a single character in the UART TX FIFO.
+*
+* Return:
+*  Non-zero if the character was placed in the FIFO.
+*
+*******************************************************************************/
+uint32_t hal_uart_put(uint32_t data)
+{
+    if(0u != uartMuted)
+    {
+        return 1u;
+    }
+    return Cy_SCB_UART_Put(CYBSP_UART_HW, data);
+}
+
+/*******************************************************************************
+* Function Name: hal_uart_put_string
+********************************************************************************
+* Summary:
+*  This function transmits a null terminated string, blocking until it has
+*  been placed in the UART TX FIFO.
+*
+*******************************************************************************/
+void hal_uart_put_string(const char *string)
+{
+    if(0u == uartMuted)
+    {
+        Cy_SCB_UART_PutString(CYBSP_UART_HW, string);
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_uart_get_num_in_rx
+********************************************************************************
+* Summary:
+*  This function returns the number of characters waiting in the UART RX FIFO.
+*
+*******************************************************************************/
+uint32_t hal_uart_get_num_in_rx(void)
+{
+    return Cy_SCB_UART_GetNumInRxFifo(CYBSP_UART_HW);
+}
+
+/*******************************************************************************
+* Function Name: hal_uart_get
+********************************************************************************
+* Summary:
+*  This function reads a single character from the UART RX FIFO.
+*
+*******************************************************************************/
+uint32_t hal_uart_get(void)
+{
+    return Cy_SCB_UART_Get(CYBSP_UART_HW);
+}
+
+/*******************************************************************************
+* Function Name: hal_uart_mute
+********************************************************************************
+* Summary:
+*  This function discards UART output while mute is non-zero, so that the
+*  cost of formatting can be measured without the transmit time.
+*
+*******************************************************************************/
+void hal_uart_mute(uint8_t mute)
+{
+    uartMuted = mute;
+}
+
+/*******************************************************************************
+* Function Name: hal_storage_init
+********************************************************************************
+* Summary:
+*  This function initializes the Emulated EEPROM in the reserved flash area.
+*
+* Return:
+*  HAL_SUCCESS or HAL_ERROR.
+*
+*******************************************************************************/
+uint32_t hal_storage_init(void)
+{
+    cy_en_em_eeprom_status_t em_eeprom_status;
+
+    /* Initialize the flash start address in Emulated EEPROM configuration
+     * structure
+     */
+    em_eeprom_config.userFlashStartAddr = (uint32_t) eepromEmptyOffset;
+
+    em_eeprom_status = Cy_Em_EEPROM_Init(&em_eeprom_config, &em_eeprom_context);
+
+    return (CY_EM_EEPROM_SUCCESS == em_eeprom_status) ? HAL_SUCCESS : HAL_ERROR;
+}
+
+/*******************************************************************************
+* Function Name: hal_storage_read
+********************************************************************************
+* Summary:
+*  This function reads data from the Emulated EEPROM.
+*
+* Parameters:
+*    addr     Logical start address.
+*    data     Destination buffer.
+*    size     Number of bytes to read.
+*
+* Return:
+*  HAL_SUCCESS or HAL_ERROR.
+*
+*******************************************************************************/
+uint32_t hal_storage_read(uint32_t addr, void *data, uint32_t size)
+{
+    cy_en_em_eeprom_status_t em_eeprom_status;
+
+    em_eeprom_status = Cy_Em_EEPROM_Read(addr, data, size, &em_eeprom_context);
+
+    return (CY_EM_EEPROM_SUCCESS == em_eeprom_status) ? HAL_SUCCESS : HAL_ERROR;
+}
+
+/*******************************************************************************
+* Function Name: hal_storage_write
+********************************************************************************
+* Summary:
+*  This function writes data to the Emulated EEPROM.
+*
+* Parameters:
+*    addr     Logical start address.
+*    data     Source buffer.
+*    size     Number of bytes to write.
+*
+* Return:
+*  HAL_SUCCESS or HAL_ERROR.
+*
+*******************************************************************************/
+uint32_t hal_storage_write(uint32_t addr, const void *data, uint32_t size)
+{
+    cy_en_em_eeprom_status_t em_eeprom_status;
+
+    em_eeprom_status = Cy_Em_EEPROM_Write(addr, (void *)data, size, &em_eeprom_context);
+
+    return (CY_EM_EEPROM_SUCCESS == em_eeprom_status) ? HAL_SUCCESS : HAL_ERROR;
+}
+
+/*******************************************************************************
+* Function Name: hal_log_read
+********************************************************************************
+* Summary:
+*  This function copies one row of the log area. The area is read through a
+*  volatile pointer, as the compiler only knows its initial zeros.
+*
+* Parameters:
+*    row      Row index, below HAL_LOG_ROWS.
+*    data     Receives HAL_LOG_ROW_SIZE bytes.
+*
+* Return:
+*  HAL_SUCCESS or HAL_ERROR.
+*
+*******************************************************************************/
+uint32_t hal_log_read(uint32_t row, void *data)
+{
+    const volatile uint8_t *flash;
+    uint8_t *bytes = (uint8_t *)data;
+
+    if(row >= HAL_LOG_ROWS)
+    {
+        return HAL_ERROR;
+    }
+    flash = &logFlash[row * HAL_LOG_ROW_SIZE];
+    for(uint32_t i = 0u; i < HAL_LOG_ROW_SIZE; i++)
+    {
+        bytes[i] = flash[i];
+    }
+    return HAL_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: hal_log_write
+********************************************************************************
+* Summary:
+*  This function erases and programs one row of the log area. The CPU stalls
+*  for the duration of the write, a few milliseconds.
+*
+* Parameters:
+*    row      Row index, below HAL_LOG_ROWS.
+*    data     HAL_LOG_ROW_SIZE bytes, 4 byte aligned.
+*
+* Return:
+*  HAL_SUCCESS or HAL_ERROR.
+*
+*******************************************************************************/
+uint32_t hal_log_write(uint32_t row, const void *data)
+{
+    cy_en_flashdrv_status_t flash_status;
+
+    if(row >= HAL_LOG_ROWS)
+    {
+        return HAL_ERROR;
+    }
+    flash_status = Cy_Flash_WriteRow((uint32_t)&logFlash[row * HAL_LOG_ROW_SIZE],
+                                     (const uint32_t *)data);
+
+    return (CY_FLASH_DRV_SUCCESS == flash_status) ? HAL_SUCCESS : HAL_ERROR;
+}
+
+/*******************************************************************************
+* Function Name: hal_delay_ms
+********************************************************************************
+* Summary:
+*  This function blocks for the given number of milliseconds.
+*
+*******************************************************************************/
+void hal_delay_ms(uint32_t ms)
+{
+    Cy_SysLib_Delay(ms);
+}
+
+/*******************************************************************************
+* Function Name: hal_time_ms
+********************************************************************************
+* Summary:
+*  This function returns the milliseconds elapsed since hal_init().
+*
+*******************************************************************************/
+uint32_t hal_time_ms(void)
+{
+    return timeMs;
+}
+
+/*******************************************************************************
+* Function Name: hal_timer_ticks
+********************************************************************************
+* Summary:
+*  This function returns a free running CPU clock tick counter built from the
+*  millisecond count and the SysTick down counter. It wraps around, so only
+*  differences between two readings are meaningful.
+*
+*******************************************************************************/
+uint32_t hal_timer_ticks(void)
+{
+    uint32_t ms;
+    uint32_t value;
+
+    /* Re-read if the millisecond count changed while sampling SysTick */
+    do
+    {
+        ms = timeMs;
+        value = Cy_SysTick_GetValue();
+    } while(ms != timeMs);
+
+    return (ms * TICKS_PER_MS) + ((TICKS_PER_MS - 1u) - value);
+}
+
+/*******************************************************************************
+* Function Name: hal_timer_ticks_per_us
+********************************************************************************
+* Summary:
+*  This function returns the number of hal_timer_ticks() per microsecond.
+*
+*******************************************************************************/
+uint32_t hal_timer_ticks_per_us(void)
+{
+    return SystemCoreClock / 1000000u;
+}
+
+/*******************************************************************************
+* Function Name: systick_callback
+********************************************************************************
+* Summary:
+*  SysTick callback that advances the millisecond time base.
+*
+*******************************************************************************/
+static void systick_callback(void)
+{
+    timeMs++;
+}
+
+/*******************************************************************************
+* Function Name: capsense_isr
+********************************************************************************
+* Summary:
+* Wrapper function for handling interrupts from CAPSENSE block.
+*
+*******************************************************************************/
+static void capsense_isr(void)
+{
+    Cy_CapSense_InterruptHandler(CYBSP_CAPSENSE_HW, &cy_capsense_context);
+}
+
+/*******************************************************************************
+* Function Name: capsense_end_of_scan
+********************************************************************************
+* Summary:
+* End of scan callback of the CAPSENSE middleware, called from capsense_isr()
+* once the raw counts of the last sensor are stored.
+*
+*******************************************************************************/
+static void capsense_end_of_scan(cy_stc_capsense_active_scan_sns_t *ptrActiveScan)
+{
+    hal_callback_t callback = scanCallback;
+
+    (void)ptrActiveScan;
+    if((NULL != callback) && (0u == scanOne))
+    {
+        callback();
+    }
+}
+
+#if CAPSENSE_TUNER_EN
+/*******************************************************************************
+* Function Name: initialize_capsense_tuner
+********************************************************************************
+* Summary:
+* - EZI2C module to communicate with the CAPSENSE Tuner tool.
+*
+*******************************************************************************/
+static void initialize_capsense_tuner(void)
+{
+    cy_en_scb_ezi2c_status_t status = CY_SCB_EZI2C_SUCCESS;
+
+    /* EZI2C interrupt configuration structure */
+    const cy_stc_sysint_t ezi2c_intr_config =
+    {
+        .intrSrc = CYBSP_EZI2C_IRQ,
+        .intrPriority = EZI2C_INTR_PRIORITY,
+    };
+
+    /* Initialize the EzI2C firmware module */
+    status = Cy_SCB_EZI2C_Init(CYBSP_EZI2C_HW, &CYBSP_EZI2C_config, &ezi2c_context);
+
+    if(status != CY_SCB_EZI2C_SUCCESS)
+    {
+        CY_ASSERT(CY_ASSERT_FAILED);
+    }
+
+    Cy_SysInt_Init(&ezi2c_intr_config, ezi2c_isr);
+    NVIC_EnableIRQ(ezi2c_intr_config.intrSrc);
+
+    /* Set the CAPSENSE data structure as the I2C buffer to be exposed to the
+     * master on primary slave address interface. Any I2C host tools such as
+     * the Tuner or the Bridge Control Panel can read this buffer but you can
+     * connect only one tool at a time.
+     */
+    Cy_SCB_EZI2C_SetBuffer1(CYBSP_EZI2C_HW, (uint8_t *)&cy_capsense_tuner,
+                            sizeof(cy_capsense_tuner), sizeof(cy_capsense_tuner),
+                            &ezi2c_context);
+
+    /* Enables the SCB block for the EZI2C operation. */
+    Cy_SCB_EZI2C_Enable(CYBSP_EZI2C_HW);
+
+    /* EZI2C initialization failed */
+    if(status != CY_SCB_EZI2C_SUCCESS)
+    {
+        CY_ASSERT(CY_ASSERT_FAILED);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ezi2c_isr
+********************************************************************************
+* Summary:
+*  Wrapper function for handling interrupts from EZI2C block.
+*
+*******************************************************************************/
+static void ezi2c_isr(void)
+{
+    Cy_SCB_EZI2C_Interrupt(CYBSP_EZI2C_HW, &ezi2c_context);
+}
+
+#endif /* CAPSENSE_TUNER_EN */
+
+/* [] END OF FILE */
@@ -0,0 +1,246 @@
+/*******************************************************************************
+* File Name: history.c
+*
+* Description: This file contains the RAM history of level records. One packed
+*              record is kept per frame in a ring, so that a host that polls
+*              occasionally can fetch minutes of history in one binary download.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "history.h"
+#include "crc.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define HISTORY_INDEX_MASK  (HISTORY_DEPTH - 1u)
+#define HISTORY_LEVEL_MAX   (HISTORY_LEVEL_MASK >> HISTORY_LEVEL_POS)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void history_put_byte(uint8_t data, uint16_t *crc);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint32_t historyRecord[HISTORY_DEPTH];
+static uint16_t historyHead = 0;        /* Index of the next record to write */
+static uint16_t historyCount = 0;
+static uint32_t historyNewestMs = 0;
+
+
+/*******************************************************************************
+* Function Name: history_process_frame
+********************************************************************************
+* Summary:
+*  This function packs the level of the frame just processed and adds it to
+*  the ring, overwriting the oldest record when full.
+*
+*******************************************************************************/
+void history_process_frame(void)
+{
+    uint32_t now = hal_time_ms();
+    /* 24.8 mm to 0.1 mm, rounded */
+    int32_t level = ((levelMm * 10) + 128) >> 8;
+
+    if(level < 0)
+    {
+        level = 0;
+    }
+    if(level > (int32_t)HISTORY_LEVEL_MAX)
+    {
+        level = HISTORY_LEVEL_MAX;
+    }
+
+    historyRecord[historyHead] = ((now / HISTORY_TICK_MS) << HISTORY_TIME_POS) |
+                                 ((uint32_t)level << HISTORY_LEVEL_POS) |
+                                 (sensorActiveCount & HISTORY_COUNT_MASK);
+    historyHead = (historyHead + 1u) & HISTORY_INDEX_MASK;
+    if(historyCount < HISTORY_DEPTH)
+    {
+        historyCount++;
+    }
+    historyNewestMs = now;
+}
+
+/*******************************************************************************
+* Function Name: history_clear
+********************************************************************************
+* Summary:
+*  This function discards all records.
+*
+*******************************************************************************/
+void history_clear(void)
+{
+    historyHead = 0;
+    historyCount = 0;
+}
+
+/*******************************************************************************
+* Function Name: history_display_stats
+********************************************************************************
+* Summary:
+*  This function prints the statistics of the newest records as
+*    Records=n SpanMs=t MinMm=x MaxMm=x MeanMm=x LastMm=x
+*  Levels are in mm with one decimal.
+*
+* Parameters:
+*    seconds    Age limit of the records included, 0 for all.
+*
+*******************************************************************************/
+void history_display_stats(uint32_t seconds)
+{
+    uint16_t index = historyHead;
+    uint16_t tick;
+    uint16_t prevTick = 0;
+    uint32_t ageTicks = 0;
+    uint32_t spanTicks = 0;
+    uint32_t limitTicks = seconds * (1000u / HISTORY_TICK_MS);
+    uint16_t records = 0;
+    uint32_t level;
+    uint32_t minLevel = HISTORY_LEVEL_MAX;
+    uint32_t maxLevel = 0;
+    uint32_t lastLevel = 0;
+    uint32_t sumLevel = 0;
+
+    /* Walk from the newest record back while within the age limit */
+    for(uint16_t n = 0; n < historyCount; n++)
+    {
+        index = (index - 1u) & HISTORY_INDEX_MASK;
+        tick = (uint16_t)(historyRecord[index] >> HISTORY_TIME_POS);
+        if(n > 0u)
+        {
+            /* Consecutive records are less than one wrap apart */
+            ageTicks += (uint16_t)(prevTick - tick);
+        }
+        prevTick = tick;
+        if((seconds != 0u) && (ageTicks > limitTicks))
+        {
+            break;
+        }
+
+        level = (historyRecord[index] & HISTORY_LEVEL_MASK) >> HISTORY_LEVEL_POS;
+        if(n == 0u)
+        {
+            lastLevel = level;
+        }
+        minLevel = (level < minLevel) ? level : minLevel;
+        maxLevel = (level > maxLevel) ? level : maxLevel;
+        sumLevel += level;
+        spanTicks = ageTicks;
+        records++;
+    }
+
+    hal_uart_put_string("Records=");
+    display_decimal_val(records, 0);
+    hal_uart_put_string(" SpanMs=");
+    display_decimal_val((int32_t)(spanTicks * HISTORY_TICK_MS), 0);
+    if(records > 0u)
+    {
+        hal_uart_put_string(" MinMm=");
+        display_decimal_fixed_val((int32_t)((minLevel << 8) / 10u), 8, 1);
+        hal_uart_put_string(" MaxMm=");
+        display_decimal_fixed_val((int32_t)((maxLevel << 8) / 10u), 8, 1);
+        hal_uart_put_string(" MeanMm=");
+        display_decimal_fixed_val((int32_t)(((sumLevel << 8) / records) / 10u), 8, 1);
+        hal_uart_put_string(" LastMm=");
+        display_decimal_fixed_val((int32_t)((lastLevel << 8) / 10u), 8, 1);
+    }
+    hal_uart_put_string("\r\n");
+}
+
+/*******************************************************************************
+* Function Name: history_download
+********************************************************************************
+* Summary:
+*  This function sends all records in the binary format described in
+*  history.h. Level output should be stopped first so that no text is mixed
+*  into the download.
+*
+*******************************************************************************/
+void history_download(void)
+{
+    uint16_t crc = CRC16_INIT;
+    uint16_t index = (historyHead - historyCount) & HISTORY_INDEX_MASK;
+    const char *magic = HISTORY_MAGIC;
+    uint32_t record;
+
+    hal_uart_put_string(magic);
+    history_put_byte(HISTORY_VERSION, &crc);
+    history_put_byte(sizeof(historyRecord[0]), &crc);
+    history_put_byte((uint8_t)historyCount, &crc);
+    history_put_byte((uint8_t)(historyCount >> 8), &crc);
+    for(uint8_t shift = 0; shift < 32u; shift += 8u)
+    {
+        history_put_byte((uint8_t)(historyNewestMs >> shift), &crc);
+    }
+    for(uint16_t n = 0; n < historyCount; n++)
+    {
+        record = historyRecord[index];
+        for(uint8_t shift = 0; shift < 32u; shift += 8u)
+        {
+            history_put_byte((uint8_t)(record >> shift), &crc);
+        }
+        index = (index + 1u) & HISTORY_INDEX_MASK;
+    }
+    /* The CRC is sent without being added to itself */
+    record = crc;
+    history_put_byte((uint8_t)record, &crc);
+    history_put_byte((uint8_t)(record >> 8), &crc);
+}
+
+/*******************************************************************************
+* Function Name: history_put_byte
+********************************************************************************
+* Summary:
+*  This function sends one byte, waiting for room in the UART FIFO, and adds it
+*  to the CRC.
+*
+*******************************************************************************/
+static void history_put_byte(uint8_t data, uint16_t *crc)
+{
+    while(0UL == hal_uart_put(data))
+    {
+
+    }
+    *crc = crc16_update(*crc, data);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,87 @@
+/*******************************************************************************
+* File Name: history.h
+*
+* Description: This file is the public interface of history.c source file.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef SOURCE_HISTORY_H_
+#define SOURCE_HISTORY_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Records held in RAM, a power of two. One record is stored per frame. */
+#define HISTORY_DEPTH               (1024u)
+
+/* Record layout, one uint32_t per frame:
+ *   bits  0..4   sensorActiveCount (0..22)
+ *   bits  5..15  level in 0.1 mm
+ *   bits 16..31  time in 10 ms ticks, modulo 2^16
+ * The time wraps every 655.36 s. Records are always much closer together, so
+ * the download carries the full time of the newest record and older times are
+ * rebuilt from the differences.
+ */
+#define HISTORY_COUNT_MASK          (0x0000001Fu)
+#define HISTORY_LEVEL_POS           (5u)
+#define HISTORY_LEVEL_MASK          (0x0000FFE0u)
+#define HISTORY_TIME_POS            (16u)
+#define HISTORY_TICK_MS             (10u)
+
+/* Binary download: magic, then version, record size, count (u16), newest
+ * time in ms (u32), the records oldest first and a CRC-16/CCITT-FALSE of
+ * everything after the magic. Multi-byte fields are little endian.
+ */
+#define HISTORY_MAGIC               "HIST"
+#define HISTORY_VERSION             (1u)
+#define HISTORY_HEADER_SIZE         (12u)
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void history_process_frame(void);
+void history_clear(void);
+void history_display_stats(uint32_t seconds);
+void history_download(void);
+
+#endif /* SOURCE_HISTORY_H_ */
+
+
+/* [] END OF FILE  */
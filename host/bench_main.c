@@ -0,0 +1,213 @@
+/*******************************************************************************
+* File Name: bench_main.c
+*
+* Description: This file is the entry point of lls_bench. It runs the shared
+*              benchmark suite natively, or compares two result files captured
+*              from the host or from the target UART.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "hal_posix.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MAX_STAGES          (32u)
+#define MAX_NAME            (32u)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* One benchmark result row */
+typedef struct
+{
+    char name[MAX_NAME];
+    double nsPerIter;
+} bench_result_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int load_results(const char *path, bench_result_t *results, uint32_t *count);
+static int compare(const char *before, const char *after, double tolerance);
+static void usage(const char *name);
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = 1300000u;
+    const char *before = NULL;
+    const char *after = NULL;
+    double tolerance = 0.10;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if((0 == strcmp(argv[i], "--iterations")) && (i + 1 < argc))
+        {
+            iterations = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if((0 == strcmp(argv[i], "--compare")) && (i + 2 < argc))
+        {
+            before = argv[++i];
+            after = argv[++i];
+        }
+        else if((0 == strcmp(argv[i], "--tolerance")) && (i + 1 < argc))
+        {
+            tolerance = strtod(argv[++i], NULL);
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(NULL != before)
+    {
+        return compare(before, after, tolerance);
+    }
+
+    hal_init();
+    /* No UART input: the report_csv stage polls for commands */
+    hal_posix_set_rx_data((const uint8_t *)"", 0u);
+    bench_run(iterations);
+    return EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: load_results
+********************************************************************************
+* Summary:
+*  This function reads the Stage,Iterations,Ticks,... rows of a result file.
+*  Other lines, such as the banner of a target UART capture, are ignored.
+*
+*******************************************************************************/
+static int load_results(const char *path, bench_result_t *results, uint32_t *count)
+{
+    FILE *file = fopen(path, "r");
+    char line[256];
+
+    if(NULL == file)
+    {
+        perror(path);
+        return -1;
+    }
+    *count = 0u;
+    while((NULL != fgets(line, sizeof(line), file)) && (*count < MAX_STAGES))
+    {
+        char name[MAX_NAME];
+        unsigned long iterations;
+        unsigned long ticks;
+        unsigned long perIter;
+        unsigned long perUs;
+
+        if((5 == sscanf(line, "%31[a-z_],%lu,%lu,%lu,%lu", name, &iterations, &ticks, &perIter, &perUs)) &&
+           (0u != iterations) && (0u != perUs))
+        {
+            strcpy(results[*count].name, name);
+            results[*count].nsPerIter = (double)ticks * 1000.0 / ((double)iterations * (double)perUs);
+            (*count)++;
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: compare
+********************************************************************************
+* Summary:
+*  This function prints the per-stage time of two result files. Stages that
+*  got slower by more than the tolerance are flagged and make the exit code
+*  non-zero.
+*
+*******************************************************************************/
+static int compare(const char *before, const char *after, double tolerance)
+{
+    bench_result_t old[MAX_STAGES];
+    bench_result_t new[MAX_STAGES];
+    uint32_t oldCount;
+    uint32_t newCount;
+    int regressions = 0;
+
+    if((0 != load_results(before, old, &oldCount)) || (0 != load_results(after, new, &newCount)))
+    {
+        return EXIT_FAILURE;
+    }
+
+    printf("Stage,BeforeNs,AfterNs,Ratio,Status\n");
+    for(uint32_t i = 0; i < newCount; i++)
+    {
+        for(uint32_t j = 0; j < oldCount; j++)
+        {
+            if(0 == strcmp(new[i].name, old[j].name))
+            {
+                double ratio = (old[j].nsPerIter > 0.0) ? new[i].nsPerIter / old[j].nsPerIter : 0.0;
+                uint8_t slower = (ratio > 1.0 + tolerance) ? 1u : 0u;
+
+                printf("%s,%.2f,%.2f,%.3f,%s\n", new[i].name, old[j].nsPerIter,
+                       new[i].nsPerIter, ratio, slower ? "REGRESSION" : "ok");
+                regressions += slower;
+            }
+        }
+    }
+    return (0 == regressions) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [--iterations N]\n"
+            "       %s --compare BEFORE AFTER [--tolerance F]\n"
+            "  --iterations N   Calls per stage (default 1300000)\n"
+            "  --compare        Compare two result files, from the host or a target capture\n"
+            "  --tolerance F    Allowed slowdown before a stage is flagged (default 0.10)\n",
+            name, name);
+}
+
+
+/* [] END OF FILE */
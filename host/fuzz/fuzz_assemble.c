@@ -0,0 +1,94 @@
+/*******************************************************************************
+* File Name: fuzz_assemble.c
+*
+* Description: This file fuzzes the UART command path. The input is fed
+*              byte by byte through the serial stand-in to receive_uart_cmd(),
+*              exactly as the main loop does on the target.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "fuzz.h"
+#include "hal_posix.h"
+#include "interface.h"
+
+#include <stdlib.h>
+
+/*******************************************************************************
+* Function Name: discard_tx
+********************************************************************************
+* Summary:
+*  This function drops the echo and the replies so that a run stays quiet.
+*
+*******************************************************************************/
+static void discard_tx(uint32_t data, void *context)
+{
+    (void)data;
+    (void)context;
+}
+
+/*******************************************************************************
+* Function Name: LLVMFuzzerTestOneInput
+********************************************************************************
+* Summary:
+*  This function runs one input through the command assembler and checks that
+*  the resulting state is one the main loop can handle.
+*
+*******************************************************************************/
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static const uint8_t flush = '\n';
+
+    hal_posix_set_tx_sink(discard_tx, NULL);
+
+    hal_posix_set_rx_data(data, size);
+    while(0UL != hal_uart_get_num_in_rx())
+    {
+        receive_uart_cmd();
+        display_next_level_val();
+    }
+    /* Complete a trailing partial line so the next input starts clean */
+    hal_posix_set_rx_data(&flush, 1u);
+    receive_uart_cmd();
+    display_next_level_val();
+
+    if((uartTxMode > UART_CSV) || (cal_flag > TRUE) ||
+       (FALSE != storeSampleFlag) || (FALSE != resetSampleFlag))
+    {
+        abort();
+    }
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/*******************************************************************************
+* File Name: fuzz_dispatch.c
+*
+* Description: This file fuzzes dispatch_uart_cmd() with arbitrary command
+*              lines, including lines the assembler can never produce.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "fuzz.h"
+#include "hal_posix.h"
+#include "interface.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MAX_LINE            (256u)
+
+/*******************************************************************************
+* Function Name: discard_tx
+********************************************************************************
+* Summary:
+*  This function drops the replies so that a run stays quiet.
+*
+*******************************************************************************/
+static void discard_tx(uint32_t data, void *context)
+{
+    (void)data;
+    (void)context;
+}
+
+/*******************************************************************************
+* Function Name: LLVMFuzzerTestOneInput
+********************************************************************************
+* Summary:
+*  This function dispatches the input as one command line. The line is copied
+*  to an exactly sized buffer so that any over-read is caught by the address
+*  sanitizer.
+*
+*******************************************************************************/
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    char *line;
+
+    if(size > MAX_LINE)
+    {
+        size = MAX_LINE;
+    }
+    line = malloc(size + 1u);
+    if(NULL == line)
+    {
+        return 0;
+    }
+    memcpy(line, data, size);
+    line[size] = '\0';
+
+    hal_posix_set_tx_sink(discard_tx, NULL);
+    dispatch_uart_cmd(line);
+    display_next_level_val();
+    free(line);
+
+    if((uartTxMode > UART_CSV) || (cal_flag > TRUE))
+    {
+        abort();
+    }
+    cal_flag = FALSE;
+    return 0;
+}
+
+/* [] END OF FILE */
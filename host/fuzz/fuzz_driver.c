@@ -0,0 +1,151 @@
+/*******************************************************************************
+* File Name: fuzz_driver.c
+*
+* Description: This file runs a fuzzing harness without libFuzzer. Each
+*              argument is a file or a directory of files passed to the harness once;
+*              without arguments one input is read from stdin, which suits AFL.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "fuzz.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MAX_INPUT           (1024u * 1024u)
+
+/*******************************************************************************
+* Function Name: run_stream
+********************************************************************************
+* Summary:
+*  This function reads one input from a stream and runs the harness on it.
+*
+*******************************************************************************/
+static void run_stream(FILE *stream)
+{
+    uint8_t *data = malloc(MAX_INPUT);
+    size_t size;
+
+    if(NULL == data)
+    {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    size = fread(data, 1u, MAX_INPUT, stream);
+    (void)LLVMFuzzerTestOneInput(data, size);
+    free(data);
+}
+
+/*******************************************************************************
+* Function Name: run_path
+********************************************************************************
+* Summary:
+*  This function runs the harness on a file, or on every file in a directory.
+*  Returns the number of inputs run.
+*
+*******************************************************************************/
+static unsigned run_path(const char *path)
+{
+    struct stat info;
+    unsigned count = 0u;
+    FILE *stream;
+    DIR *dir;
+    struct dirent *entry;
+    char child[4096];
+
+    if(0 != stat(path, &info))
+    {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    if(S_ISDIR(info.st_mode))
+    {
+        dir = opendir(path);
+        if(NULL == dir)
+        {
+            perror(path);
+            exit(EXIT_FAILURE);
+        }
+        while(NULL != (entry = readdir(dir)))
+        {
+            if('.' != entry->d_name[0])
+            {
+                snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+                count += run_path(child);
+            }
+        }
+        closedir(dir);
+        return count;
+    }
+
+    stream = fopen(path, "rb");
+    if(NULL == stream)
+    {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    run_stream(stream);
+    fclose(stream);
+    return 1u;
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    unsigned count = 0u;
+    int i;
+
+    if(argc < 2)
+    {
+        run_stream(stdin);
+        return EXIT_SUCCESS;
+    }
+    for(i = 1; i < argc; i++)
+    {
+        count += run_path(argv[i]);
+    }
+    printf("%s: %u inputs passed\n", argv[0], count);
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
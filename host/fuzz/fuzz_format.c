@@ -0,0 +1,216 @@
+/*******************************************************************************
+* File Name: fuzz_format.c
+*
+* Description: This file fuzzes display_decimal_val() and
+*              display_decimal_fixed_val(). The text they transmit is captured through
+*              the serial stand-in and compared with a snprintf() reference.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "fuzz.h"
+#include "hal_posix.h"
+#include "interface.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MAX_TEXT            (64u)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Characters transmitted by the function under test */
+typedef struct
+{
+    char text[MAX_TEXT];
+    size_t length;
+} capture_t;
+
+/*******************************************************************************
+* Function Name: capture_tx
+********************************************************************************
+* Summary:
+*  This function appends one transmitted character to the capture buffer.
+*
+*******************************************************************************/
+static void capture_tx(uint32_t data, void *context)
+{
+    capture_t *capture = (capture_t *)context;
+
+    /* No valid output comes close to the buffer size */
+    if(capture->length >= (MAX_TEXT - 1u))
+    {
+        abort();
+    }
+    capture->text[capture->length++] = (char)data;
+    capture->text[capture->length] = '\0';
+}
+
+/*******************************************************************************
+* Function Name: expect_decimal
+********************************************************************************
+* Summary:
+*  This function prints the text display_decimal_val() is specified to send:
+*  an optional sign followed by the magnitude padded with zeros to
+*  leading_zeros digits (at most 10, at least 1).
+*
+*******************************************************************************/
+static size_t expect_decimal(char *text, size_t size, int32_t number, int8_t leading_zeros)
+{
+    uint32_t magnitude = (uint32_t)number;
+    int width = leading_zeros;
+
+    if(width > 10)
+    {
+        width = 10;
+    }
+    if(width < 1)
+    {
+        width = 1;
+    }
+    if(number < 0)
+    {
+        magnitude = 0u - magnitude;
+    }
+    return (size_t)snprintf(text, size, "%s%0*" PRIu32, (number < 0) ? "-" : "",
+                            width, magnitude);
+}
+
+/*******************************************************************************
+* Function Name: expect_fixed
+********************************************************************************
+* Summary:
+*  This function prints the text display_decimal_fixed_val() is specified to
+*  send: an optional sign, the integer part of the magnitude, then its
+*  fraction bits truncated to num_decimal digits.
+*
+*******************************************************************************/
+static void expect_fixed(char *text, size_t size, int32_t number, uint8_t fixed_shift,
+                         uint8_t num_decimal)
+{
+    size_t length;
+    uint32_t magnitude = (uint32_t)number;
+    uint64_t fraction;
+    uint64_t scale = 1u;
+    uint8_t i;
+
+    if(fixed_shift > 31u)
+    {
+        fixed_shift = 31u;
+    }
+    if(num_decimal > 9u)
+    {
+        num_decimal = 9u;
+    }
+    if(number < 0)
+    {
+        magnitude = 0u - magnitude;
+    }
+    length = (size_t)snprintf(text, size, "%s%" PRIu32, (number < 0) ? "-" : "",
+                              magnitude >> fixed_shift);
+    if(num_decimal > 0u)
+    {
+        for(i = 0u; i < num_decimal; i++)
+        {
+            scale *= 10u;
+        }
+        fraction = magnitude & (uint32_t)((1ull << fixed_shift) - 1u);
+        fraction = (fraction * scale) >> fixed_shift;
+        snprintf(text + length, size - length, ".%0*" PRIu64, (int)num_decimal, fraction);
+    }
+}
+
+/*******************************************************************************
+* Function Name: LLVMFuzzerTestOneInput
+********************************************************************************
+* Summary:
+*  This function decodes a number, a fixed point shift, a decimal count and a
+*  leading zero count from the input and checks both formatters.
+*
+*  Input layout: int32 number (little endian), uint8 fixed_shift,
+*  uint8 num_decimal, int8 leading_zeros. Missing bytes read as zero.
+*
+*******************************************************************************/
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    uint8_t bytes[7] = {0u};
+    int32_t number;
+    uint8_t fixed_shift;
+    uint8_t num_decimal;
+    int8_t leading_zeros;
+    capture_t capture;
+    char expected[MAX_TEXT];
+
+    memcpy(bytes, data, (size < sizeof(bytes)) ? size : sizeof(bytes));
+    number = (int32_t)((uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+                       ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24));
+    fixed_shift = bytes[4];
+    num_decimal = bytes[5];
+    leading_zeros = (int8_t)bytes[6];
+
+    hal_posix_set_tx_sink(capture_tx, &capture);
+
+    capture.length = 0u;
+    capture.text[0] = '\0';
+    display_decimal_val(number, leading_zeros);
+    expect_decimal(expected, sizeof(expected), number, leading_zeros);
+    if(0 != strcmp(expected, capture.text))
+    {
+        fprintf(stderr, "display_decimal_val(%" PRId32 ", %d): \"%s\", expected \"%s\"\n",
+                number, leading_zeros, capture.text, expected);
+        abort();
+    }
+
+    capture.length = 0u;
+    capture.text[0] = '\0';
+    display_decimal_fixed_val(number, fixed_shift, num_decimal);
+    expect_fixed(expected, sizeof(expected), number, fixed_shift, num_decimal);
+    if(0 != strcmp(expected, capture.text))
+    {
+        fprintf(stderr, "display_decimal_fixed_val(%" PRId32 ", %u, %u): \"%s\", expected \"%s\"\n",
+                number, fixed_shift, num_decimal, capture.text, expected);
+        abort();
+    }
+
+    hal_posix_set_tx_sink(NULL, NULL);
+    return 0;
+}
+
+/* [] END OF FILE */
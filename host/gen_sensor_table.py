@@ -0,0 +1,252 @@
+#!/usr/bin/env python3
+################################################################################
+# \file gen_sensor_table.py
+# \version 1.0
+#
+# \brief
+# Generates sensor_table.h and sensor_table.c, the const sensor metadata of
+# the liquid level probe, from the CAPSENSE configurator design file. The
+# sensor count, widget ids and raw count resolution come from the design; the
+# probe geometry, default scale and self-test limits, which the configurator
+# does not hold, are listed in PROBE below by widget name.
+#
+#   gen_sensor_table.py DESIGN OUTDIR          Write OUTDIR/sensor_table.[ch]
+#   gen_sensor_table.py --check DESIGN OUTDIR  Exit 1 if they are out of date
+#
+################################################################################
+# \copyright
+# Copyright 2018-2023, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import os
+import sys
+import xml.etree.ElementTree as ET
+
+NS = {'c': 'http://cypress.com/xsd/cyconfigurationfile_v1'}
+
+# Probe properties per widget: (height in half sensor units, scale in 8.8,
+# self-test capacitance limits in pF). The end electrodes are half the height
+# of the middle ones and need more gain to reach the same full scale count.
+# The capacitance limits are wide enough for any CY8CKIT-022 probe and cable
+# and catch an open or missing electrode; narrow them from the self-test
+# report of known good probes.
+PROBE_DEFAULT = (2, 0x0100, 5, 60)
+PROBE = {
+    'Button0':  (1, 0x01D0, 3, 40),
+    'Button11': (1, 0x01C0, 3, 40),
+}
+
+LEGAL = """*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/"""
+
+
+def banner(name, desc):
+    return ('/*******************************************************************************\n'
+            '* File Name: %s\n'
+            '*\n'
+            '* Description: %s\n'
+            '*              Generated by host/gen_sensor_table.py from design.cycapsense.\n'
+            '*              Do not edit; run make -C host gen after changing the design.\n'
+            '*\n'
+            '* Related Document: README.md\n'
+            '%s\n' % (name, desc, LEGAL))
+
+
+def read_design(path):
+    root = ET.parse(path).getroot()
+    widgets = []
+    for widget in root.findall('./c:Widgets/c:Widget', NS):
+        props = {p.get('id'): p.get('value')
+                 for p in widget.findall('./c:WidgetProperties/c:Property', NS)}
+        sensors = widget.findall('./c:Electrodes/c:Electrode[@kind="Sensor"]', NS)
+        if widget.get('type') != 'CSD_BUTTON' or len(sensors) != 1:
+            sys.exit('%s: widget %s must be a CSD button with one sensor'
+                     % (path, widget.get('id')))
+        widgets.append((widget.get('id'), props))
+    if not widgets:
+        sys.exit('%s: no widgets' % path)
+    resolutions = {props['RESOLUTION'] for _, props in widgets}
+    if len(resolutions) != 1:
+        sys.exit('%s: all widgets must share RESOLUTION' % path)
+    return widgets, int(resolutions.pop().replace('RES', '').replace('BIT', ''))
+
+
+# Bits of the wet sensor mask that one sensorMaskUnits[] row covers
+MASK_GROUP_BITS = 6
+
+
+def mask_groups(widgets):
+    return (len(widgets) + MASK_GROUP_BITS - 1) // MASK_GROUP_BITS
+
+
+def emit_header(widgets, resolution):
+    units = sum(PROBE.get(name, PROBE_DEFAULT)[0] for name, _ in widgets)
+    return (banner('sensor_table.h', 'Sensor metadata of the liquid level probe.') +
+            '/*******************************************************************************\n'
+            ' * Include guard\n'
+            ' ******************************************************************************/\n'
+            '#ifndef SOURCE_SENSOR_TABLE_H_\n'
+            '#define SOURCE_SENSOR_TABLE_H_\n'
+            '\n'
+            '#include <stdint.h>\n'
+            '\n'
+            '/*******************************************************************************\n'
+            '* Global constants\n'
+            '*******************************************************************************/\n'
+            '/* Number of CAPSENSE widgets, one sensor each, bottom to top */\n'
+            '#define SENSOR_COUNT                (%uu)\n'
+            '/* Raw count resolution of the widgets */\n'
+            '#define SENSOR_RESOLUTION_BITS      (%uu)\n'
+            '/* Probe height in half middle sensor heights */\n'
+            '#define SENSOR_HEIGHT_UNITS         (%uu)\n'
+            '/* The wet sensor mask, bit i for sensor i, is looked up in groups of\n'
+            ' * SENSOR_MASK_GROUP_BITS bits, group 0 at the bottom\n'
+            ' */\n'
+            '#define SENSOR_MASK_GROUP_BITS      (%uu)\n'
+            '#define SENSOR_MASK_GROUPS          (%uu)\n'
+            '\n'
+            '/*******************************************************************************\n'
+            '* External variables\n'
+            '*******************************************************************************/\n'
+            'extern const uint8_t sensorWidgetId[SENSOR_COUNT];\n'
+            'extern const uint8_t sensorHeightUnits[SENSOR_COUNT];\n'
+            'extern const int16_t sensorScaleDefault[SENSOR_COUNT];\n'
+            'extern const uint8_t sensorCapMinPf[SENSOR_COUNT];\n'
+            'extern const uint8_t sensorCapMaxPf[SENSOR_COUNT];\n'
+            'extern const uint8_t sensorMaskUnits[SENSOR_MASK_GROUPS][1u << SENSOR_MASK_GROUP_BITS];\n'
+            '\n'
+            '#endif /* SOURCE_SENSOR_TABLE_H_ */\n'
+            '\n'
+            '\n'
+            '/* [] END OF FILE */\n' % (len(widgets), resolution, units, MASK_GROUP_BITS,
+                                        mask_groups(widgets)))
+
+
+def emit_mask_units(widgets):
+    heights = [PROBE.get(w, PROBE_DEFAULT)[0] for w, _ in widgets]
+    rows = []
+    for group in range(mask_groups(widgets)):
+        first = group * MASK_GROUP_BITS
+        values = ['%2uu' % sum(h for i, h in enumerate(heights[first:first + MASK_GROUP_BITS])
+                               if (bits >> i) & 1)
+                  for bits in range(1 << MASK_GROUP_BITS)]
+        rows.append('    /* %s to %s */\n'
+                    '    {\n%s\n    },' % (widgets[first][0],
+                                           widgets[min(first + MASK_GROUP_BITS, len(widgets)) - 1][0],
+                                           '\n'.join('        ' + ', '.join(values[n:n + 16]) + ','
+                                                     for n in range(0, len(values), 16))))
+    return ('/* Submerged height in half middle sensor heights of each wet mask group */\n'
+            'const uint8_t sensorMaskUnits[SENSOR_MASK_GROUPS][1u << SENSOR_MASK_GROUP_BITS] =\n'
+            '{\n'
+            '%s\n'
+            '};\n' % '\n'.join(rows))
+
+
+def emit_source(widgets):
+    def table(ctype, name, comment, values):
+        return ('/* %s */\n'
+                'const %s %s[SENSOR_COUNT] =\n'
+                '{\n'
+                '%s\n'
+                '};\n' % (comment, ctype, name,
+                          '\n'.join('    %s,%s/* %s */' % (v, ' ' * (8 - len(v)), w)
+                                    for v, (w, _) in zip(values, widgets))))
+
+    return (banner('sensor_table.c', 'Sensor metadata of the liquid level probe.') +
+            '#include "sensor_table.h"\n'
+            '\n'
+            '/*******************************************************************************\n'
+            '* Global Variables\n'
+            '*******************************************************************************/\n' +
+            table('uint8_t', 'sensorWidgetId', 'CAPSENSE widget id of each sensor',
+                  ['%uu' % i for i in range(len(widgets))]) + '\n' +
+            table('uint8_t', 'sensorHeightUnits', 'Sensor height in half middle sensor heights',
+                  ['%uu' % PROBE.get(w, PROBE_DEFAULT)[0] for w, _ in widgets]) + '\n' +
+            table('int16_t', 'sensorScaleDefault',
+                  'Scale to normalize the full scale counts. 0x0100 = 1.0 in fixed precision 8.8',
+                  ['0x%04X' % PROBE.get(w, PROBE_DEFAULT)[1] for w, _ in widgets]) + '\n' +
+            table('uint8_t', 'sensorCapMinPf', 'Lowest sensor capacitance in pF that passes the self-test',
+                  ['%uu' % PROBE.get(w, PROBE_DEFAULT)[2] for w, _ in widgets]) + '\n' +
+            table('uint8_t', 'sensorCapMaxPf', 'Highest sensor capacitance in pF that passes the self-test',
+                  ['%uu' % PROBE.get(w, PROBE_DEFAULT)[3] for w, _ in widgets]) + '\n' +
+            emit_mask_units(widgets) +
+            '\n'
+            '\n'
+            '/* [] END OF FILE */\n')
+
+
+def main(argv):
+    check = len(argv) > 1 and argv[1] == '--check'
+    args = argv[2:] if check else argv[1:]
+    if len(args) != 2:
+        sys.exit('usage: %s [--check] DESIGN OUTDIR' % argv[0])
+    widgets, resolution = read_design(args[0])
+    outputs = {
+        'sensor_table.h': emit_header(widgets, resolution),
+        'sensor_table.c': emit_source(widgets),
+    }
+    stale = []
+    for name, text in outputs.items():
+        path = os.path.join(args[1], name)
+        try:
+            with open(path) as f:
+                current = f.read()
+        except OSError:
+            current = None
+        if current != text:
+            stale.append(path)
+            if not check:
+                with open(path, 'w') as f:
+                    f.write(text)
+    if check and stale:
+        print('Out of date, run make -C host gen: %s' % ' '.join(stale))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
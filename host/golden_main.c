@@ -0,0 +1,495 @@
+/*******************************************************************************
+* File Name: golden_main.c
+*
+* Description: This file is the entry point of lls_golden. It generates the
+*              golden vectors of the level computation from the reference
+*              implementation and checks implementations against them.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "level.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define LINE_SIZE           (1024u)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef void (*level_impl_t)(void);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void generate(void);
+static void emit_scale(void);
+static void emit_offset(const int32_t *offset);
+static void emit_frame(const int32_t *raw);
+static int check(const char *path, level_impl_t impl, uint32_t maxReport);
+static uint8_t parse_values(const char *p, int32_t *values, uint32_t count);
+static void usage(const char *name);
+static void level_process_frame_loop(void);
+static void level_process_frame_lazy_exact(void);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Implementations of level_process_frame() that can be checked */
+static const struct
+{
+    const char *name;
+    level_impl_t fn;
+} impls[] =
+{
+    {"reference",   level_process_frame},
+    {"loop",        level_process_frame_loop},
+    {"lazy",        level_process_frame_lazy_exact},
+};
+
+/* Scale tables the vectors are generated with */
+static const int16_t scaleSets[][NUMSENSORS] =
+{
+    /* Firmware default */
+    {0x01D0, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x01C0},
+    /* Unity */
+    {0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100},
+    /* Spread with attenuating and amplifying entries */
+    {0x0233, 0x00C0, 0x0111, 0x00F7, 0x0180, 0x0101, 0x00FF, 0x0140, 0x0080, 0x0200, 0x0123, 0x01FF},
+};
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    level_impl_t impl = impls[0].fn;
+    uint32_t maxReport = 10u;
+    const char *path = NULL;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(0 == strcmp(argv[i], "--generate"))
+        {
+            generate();
+            return EXIT_SUCCESS;
+        }
+        else if((0 == strcmp(argv[i], "--impl")) && (i + 1 < argc))
+        {
+            impl = NULL;
+            i++;
+            for(uint8_t n = 0; n < sizeof(impls) / sizeof(impls[0]); n++)
+            {
+                if(0 == strcmp(argv[i], impls[n].name))
+                {
+                    impl = impls[n].fn;
+                }
+            }
+            if(NULL == impl)
+            {
+                fprintf(stderr, "Unknown implementation: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if((0 == strcmp(argv[i], "--max-report")) && (i + 1 < argc))
+        {
+            maxReport = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if('-' != argv[i][0])
+        {
+            path = argv[i];
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if(NULL == path)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    return check(path, impl, maxReport);
+}
+
+/*******************************************************************************
+* Function Name: generate
+********************************************************************************
+* Summary:
+*  This function prints the golden vectors computed by the reference
+*  implementation. For each table in scaleSets[] the set covers wet masks
+*  (all 4096 for the firmware table), each sensor below zero and in single
+*  steps across SENSORLIMIT, and pseudo random frames. Raw count
+*  extremes are added at the end.
+*
+*******************************************************************************/
+static void generate(void)
+{
+    int32_t offset[NUMSENSORS];
+    int32_t raw[NUMSENSORS];
+    uint32_t rng = 12345u;
+
+    printf("# Golden vectors for the level computation in level.c.\n");
+    printf("# Generated by: lls_golden --generate. Do not edit.\n");
+    printf("# scale,<Scale0..%u>   sets sensorScale[] (fixed precision 8.8)\n", NUMSENSORS - 1u);
+    printf("# offset,<Offset0..%u> sets sensorEmptyOffset[]\n", NUMSENSORS - 1u);
+    printf("# frame,<Raw0..%u>,<Proc0..%u>,SenActCnt,LevelMm,LevelPercent (fixed precision 24.8)\n",
+           NUMSENSORS - 1u, NUMSENSORS - 1u);
+
+    for(uint8_t set = 0; set < sizeof(scaleSets) / sizeof(scaleSets[0]); set++)
+    {
+        sensorScale = scaleSets[set];
+        emit_scale();
+
+        for(uint8_t i = 0; i < NUMSENSORS; i++)
+        {
+            offset[i] = 440 + 3 * i;
+        }
+        emit_offset(offset);
+
+        /* Every wet mask for the firmware table, every 7th for the others */
+        printf("# case: wet masks, one scaled wet response of 160 counts\n");
+        for(uint32_t mask = 0; mask < (1u << NUMSENSORS); mask += ((0u == set) ? 1u : 7u))
+        {
+            for(uint8_t i = 0; i < NUMSENSORS; i++)
+            {
+                raw[i] = offset[i] + (((mask >> i) & 1u) ? ((160 * 256) / sensorScale[i]) : 0);
+            }
+            emit_frame(raw);
+        }
+
+        printf("# case: each sensor below zero and stepped across SENSORLIMIT, others dry\n");
+        for(uint8_t s = 0; s < NUMSENSORS; s++)
+        {
+            /* Smallest difference count that scales above SENSORLIMIT */
+            int32_t edge = (((int32_t)SENSORLIMIT + 1) * 256 + sensorScale[s] - 1) / sensorScale[s];
+            static const int32_t below[] = {-64, -8, -1, 0, 1};
+
+            for(uint8_t n = 0; n < sizeof(below) / sizeof(below[0]); n++)
+            {
+                memcpy(raw, offset, sizeof(raw));
+                raw[s] += below[n];
+                emit_frame(raw);
+            }
+            for(int32_t diff = edge - 4; diff <= edge + 4; diff++)
+            {
+                memcpy(raw, offset, sizeof(raw));
+                raw[s] += diff;
+                emit_frame(raw);
+            }
+        }
+
+        printf("# case: bottom run of wet sensors with all others just below zero\n");
+        for(uint8_t wet = 0; wet <= NUMSENSORS; wet++)
+        {
+            for(uint8_t i = 0; i < NUMSENSORS; i++)
+            {
+                raw[i] = offset[i] + ((i < wet) ? 200 : -1);
+            }
+            emit_frame(raw);
+        }
+
+        printf("# case: pseudo random frames around the offsets\n");
+        for(uint32_t n = 0; n < 128u; n++)
+        {
+            for(uint8_t i = 0; i < NUMSENSORS; i++)
+            {
+                rng = rng * 1103515245u + 12345u;
+                raw[i] = offset[i] - 100 + (int32_t)((rng >> 16) % 400u);
+            }
+            emit_frame(raw);
+        }
+    }
+
+    printf("# case: raw count extremes with zero offsets, firmware scales\n");
+    sensorScale = scaleSets[0];
+    memset(offset, 0, sizeof(offset));
+    emit_scale();
+    emit_offset(offset);
+    for(uint32_t n = 0; n < 4u; n++)
+    {
+        static const int32_t extremes[] = {0, 1, 1023, 65535};
+
+        for(uint8_t i = 0; i < NUMSENSORS; i++)
+        {
+            raw[i] = extremes[n];
+        }
+        emit_frame(raw);
+    }
+}
+
+/*******************************************************************************
+* Function Name: emit_scale
+*******************************************************************************/
+static void emit_scale(void)
+{
+    printf("scale");
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        printf(",%d", sensorScale[i]);
+    }
+    printf("\n");
+}
+
+/*******************************************************************************
+* Function Name: emit_offset
+********************************************************************************
+* Summary:
+*  This function prints an offset line and loads it into the pipeline.
+*
+*******************************************************************************/
+static void emit_offset(const int32_t *offset)
+{
+    printf("offset");
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        sensorEmptyOffset[i] = (uint16_t)offset[i];
+        printf(",%d", offset[i]);
+    }
+    printf("\n");
+    level_update_thresholds();
+}
+
+/*******************************************************************************
+* Function Name: emit_frame
+*******************************************************************************/
+static void emit_frame(const int32_t *raw)
+{
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        sensorRaw[i] = (uint16_t)raw[i];
+    }
+    level_process_frame();
+    level_require_processed();
+
+    printf("frame");
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        printf(",%d", sensorRaw[i]);
+    }
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        printf(",%d", sensorProcessed[i]);
+    }
+    printf(",%u,%d,%d\n", sensorActiveCount, levelMm, levelPercent);
+}
+
+/*******************************************************************************
+* Function Name: parse_values
+*******************************************************************************/
+static uint8_t parse_values(const char *p, int32_t *values, uint32_t count)
+{
+    char *end;
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+        if(',' != *p)
+        {
+            return 0u;
+        }
+        values[i] = (int32_t)strtol(p + 1, &end, 10);
+        if(end == p + 1)
+        {
+            return 0u;
+        }
+        p = end;
+    }
+    return (('\n' == *p) || ('\r' == *p) || ('\0' == *p)) ? 1u : 0u;
+}
+
+/*******************************************************************************
+* Function Name: check
+********************************************************************************
+* Summary:
+*  This function runs an implementation on every golden frame and compares
+*  Proc, SenActCnt, LevelMm and LevelPercent bit-exactly.
+*
+*******************************************************************************/
+static int check(const char *path, level_impl_t impl, uint32_t maxReport)
+{
+    FILE *file = fopen(path, "r");
+    char line[LINE_SIZE];
+    uint32_t lineNo = 0u;
+    uint32_t frames = 0u;
+    uint32_t failures = 0u;
+    static int16_t scale[NUMSENSORS];
+    uint8_t malformed = 0u;
+
+    if(NULL == file)
+    {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+
+    while(NULL != fgets(line, sizeof(line), file))
+    {
+        int32_t values[2u * NUMSENSORS + 3u];
+        uint8_t procBad;
+
+        lineNo++;
+        if(('#' == line[0]) || ('\n' == line[0]))
+        {
+            continue;
+        }
+        if(0 == strncmp(line, "scale,", 6))
+        {
+            if(0u == parse_values(line + 5, values, NUMSENSORS))
+            {
+                malformed = 1u;
+                break;
+            }
+            for(uint8_t i = 0; i < NUMSENSORS; i++)
+            {
+                scale[i] = (int16_t)values[i];
+            }
+            sensorScale = scale;
+            level_update_thresholds();
+        }
+        else if(0 == strncmp(line, "offset,", 7))
+        {
+            if(0u == parse_values(line + 6, values, NUMSENSORS))
+            {
+                malformed = 1u;
+                break;
+            }
+            for(uint8_t i = 0; i < NUMSENSORS; i++)
+            {
+                sensorEmptyOffset[i] = (uint16_t)values[i];
+            }
+            level_update_thresholds();
+        }
+        else if(0 == strncmp(line, "frame,", 6))
+        {
+            if(0u == parse_values(line + 5, values, 2u * NUMSENSORS + 3u))
+            {
+                malformed = 1u;
+                break;
+            }
+            for(uint8_t i = 0; i < NUMSENSORS; i++)
+            {
+                sensorRaw[i] = (uint16_t)values[i];
+            }
+            impl();
+            level_require_processed();
+            frames++;
+
+            procBad = 0u;
+            for(uint8_t i = 0; i < NUMSENSORS; i++)
+            {
+                procBad |= (sensorProcessed[i] != values[NUMSENSORS + i]) ? 1u : 0u;
+            }
+            if((0u != procBad) ||
+               (sensorActiveCount != values[2u * NUMSENSORS]) ||
+               (levelMm != values[2u * NUMSENSORS + 1u]) ||
+               (levelPercent != values[2u * NUMSENSORS + 2u]))
+            {
+                if(failures++ < maxReport)
+                {
+                    printf("%s:%u: expected cnt=%d mm=%d pct=%d, got cnt=%u mm=%d pct=%d\n",
+                           path, lineNo, values[2u * NUMSENSORS], values[2u * NUMSENSORS + 1u],
+                           values[2u * NUMSENSORS + 2u], sensorActiveCount, levelMm, levelPercent);
+                }
+            }
+        }
+        else
+        {
+            malformed = 1u;
+            break;
+        }
+    }
+    fclose(file);
+
+    if(0u != malformed)
+    {
+        fprintf(stderr, "%s:%u: malformed line\n", path, lineNo);
+        return EXIT_FAILURE;
+    }
+    printf("frames=%u\n", frames);
+    printf("failures=%u\n", failures);
+    return ((0u == failures) && (0u != frames)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*******************************************************************************
+* Function Name: level_process_frame_loop
+********************************************************************************
+* Summary:
+*  The level pipeline with the per-sensor compare loop and the level
+*  arithmetic instead of the wet mask lookup.
+*
+*******************************************************************************/
+static void level_process_frame_loop(void)
+{
+    level_scale_sensors();
+    level_count_submerged();
+    level_compute();
+}
+
+/*******************************************************************************
+* Function Name: level_process_frame_lazy_exact
+********************************************************************************
+* Summary:
+*  The lazy pipeline with a noise band of 0, where it must give the same
+*  results as the reference: only sensors whose raw count changed are
+*  evaluated again.
+*
+*******************************************************************************/
+static void level_process_frame_lazy_exact(void)
+{
+    if(levelLazy == 0u)
+    {
+        level_set_lazy(1u, 0u);
+    }
+    level_process_frame_lazy();
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [--impl NAME] [--max-report N] vectors.csv\n"
+            "       %s --generate > vectors.csv\n",
+            name, name);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,767 @@
+/*******************************************************************************
+* File Name: hal_posix.c
+*
+* Description: This file implements the hardware abstraction layer on a POSIX
+*              host. Sensor frames come from a pluggable frame source, the
+*              serial port is mapped to stdin/stdout, the EEPROM to a file and
+*              time to a virtual clock advanced by hal_delay_ms().
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "hal_posix.h"
+#include "sensor_table.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MAX_SENSORS         (32u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static hal_posix_frame_source_t frameSource = NULL;
+static void *frameSourceContext = NULL;
+static int32_t defaultRaw = HAL_POSIX_DEFAULT_RAW;
+static int32_t frame[MAX_SENSORS];
+static uint16_t frameRaw[MAX_SENSORS];        /* Processed frame behind the view */
+static uint32_t frameLimit = 0u;              /* 0 = run forever */
+static uint32_t frameCount = 0u;
+static hal_callback_t scanCallback = NULL;
+
+static uint8_t sensorFault[MAX_SENSORS];      /* HAL_POSIX_FAULT_* per sensor */
+
+static uint8_t alarmOutputs = 0u;
+static uint8_t alarmTrace = 0u;
+
+static const char *storageFile = NULL;
+static uint8_t storage[HAL_POSIX_STORAGE_SIZE];
+static const char *logFile = NULL;
+static uint8_t logRows[HAL_LOG_ROWS][HAL_LOG_ROW_SIZE];
+static uint8_t logLoaded = 0u;
+
+static uint8_t realtime = 0u;
+static uint32_t virtualMs = 0u;
+
+static uint8_t uartMuted = 0u;
+static hal_posix_tx_sink_t txSink = NULL;
+static void *txSinkContext = NULL;
+static const uint8_t *rxData = NULL;          /* Injected input, replaces stdin */
+static size_t rxSize = 0u;
+static int rxPending = -1;                    /* Character read ahead from stdin */
+static uint8_t rxEof = 0u;
+
+
+/*******************************************************************************
+* Function Name: hal_posix_set_frame_source
+********************************************************************************
+* Summary:
+*  This function installs the generator that produces sensor frames. Passing
+*  NULL restores the default source, which reports a constant raw count.
+*
+*******************************************************************************/
+void hal_posix_set_frame_source(hal_posix_frame_source_t source, void *context)
+{
+    frameSource = source;
+    frameSourceContext = context;
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_set_default_raw
+********************************************************************************
+* Summary:
+*  This function sets the raw count reported by the default frame source.
+*
+*******************************************************************************/
+void hal_posix_set_default_raw(int32_t raw)
+{
+    defaultRaw = raw;
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_set_frame_limit
+********************************************************************************
+* Summary:
+*  This function sets the number of frames after which the application exits.
+*  0 runs forever.
+*
+*******************************************************************************/
+void hal_posix_set_frame_limit(uint32_t frames)
+{
+    frameLimit = frames;
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_set_storage_file
+********************************************************************************
+* Summary:
+*  This function sets the file backing the emulated EEPROM. Without a file the
+*  EEPROM lives in memory only.
+*
+*******************************************************************************/
+void hal_posix_set_storage_file(const char *path)
+{
+    storageFile = path;
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_set_realtime
+********************************************************************************
+* Summary:
+*  This function makes hal_delay_ms() sleep for real instead of only advancing
+*  the virtual clock.
+*
+*******************************************************************************/
+void hal_posix_set_realtime(uint8_t enable)
+{
+    realtime = enable;
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_frame_count
+********************************************************************************
+* Summary:
+*  This function returns the number of frames read so far.
+*
+*******************************************************************************/
+uint32_t hal_posix_frame_count(void)
+{
+    return frameCount;
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_set_sensor_fault
+********************************************************************************
+* Summary:
+*  This function sets the fault that hal_sensor_self_test() reports for a
+*  sensor.
+*
+*******************************************************************************/
+void hal_posix_set_sensor_fault(uint8_t sensor, uint8_t fault)
+{
+    if(sensor < MAX_SENSORS)
+    {
+        sensorFault[sensor] = fault;
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_set_alarm_trace
+********************************************************************************
+* Summary:
+*  This function prints every change of the alarm outputs to stderr, with
+*  the virtual time and the frame being scanned, while enable is non-zero.
+*
+*******************************************************************************/
+void hal_posix_set_alarm_trace(uint8_t enable)
+{
+    alarmTrace = enable;
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_alarm_outputs
+********************************************************************************
+* Summary:
+*  This function returns the last value written to the alarm outputs.
+*
+*******************************************************************************/
+uint8_t hal_posix_alarm_outputs(void)
+{
+    return alarmOutputs;
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_set_log_file
+********************************************************************************
+* Summary:
+*  This function sets the file that holds the image of the log flash rows, so
+*  that the log survives restarts. Without one the log starts empty.
+*
+*******************************************************************************/
+void hal_posix_set_log_file(const char *path)
+{
+    logFile = path;
+    logLoaded = 0u;
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_set_tx_sink
+********************************************************************************
+* Summary:
+*  This function redirects UART output from stdout to a callback. Passing
+*  NULL restores stdout.
+*
+*******************************************************************************/
+void hal_posix_set_tx_sink(hal_posix_tx_sink_t sink, void *context)
+{
+    txSink = sink;
+    txSinkContext = context;
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_set_rx_data
+********************************************************************************
+* Summary:
+*  This function queues a buffer as UART input in place of stdin. The buffer
+*  must stay valid until it has been read.
+*
+*******************************************************************************/
+void hal_posix_set_rx_data(const uint8_t *data, size_t size)
+{
+    rxData = data;
+    rxSize = size;
+}
+
+/*******************************************************************************
+* Function Name: hal_init
+********************************************************************************
+* Summary:
+*  This function puts an interactive stdin in non-blocking mode so that it
+*  behaves like the UART RX FIFO. A redirected stdin is kept blocking and read
+*  as a script, one character per poll, so that runs are reproducible.
+*
+*******************************************************************************/
+void hal_init(void)
+{
+    int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
+
+    if((flags >= 0) && isatty(STDIN_FILENO))
+    {
+        (void)fcntl(STDIN_FILENO, F_SETFL, flags | O_NONBLOCK);
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_halt
+********************************************************************************
+* Summary:
+*  This function stops the host application with a failure exit code.
+*
+*******************************************************************************/
+void hal_halt(void)
+{
+    fflush(stdout);
+    exit(EXIT_FAILURE);
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_init
+*******************************************************************************/
+uint32_t hal_sensor_init(void)
+{
+    return HAL_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_self_test
+********************************************************************************
+* Summary:
+*  This function reports HAL_POSIX_SENSOR_CAP_FF per middle sensor height
+*  unless a fault has been set for the sensor. Each test takes
+*  HAL_POSIX_SELF_TEST_MS of virtual time.
+*
+*******************************************************************************/
+uint32_t hal_sensor_self_test(uint8_t sensor, uint32_t *capFf)
+{
+    virtualMs += HAL_POSIX_SELF_TEST_MS;
+    *capFf = 0u;
+    if(sensor >= SENSOR_COUNT)
+    {
+        return HAL_SELFTEST_ERROR;
+    }
+    if(sensorFault[sensor] == HAL_POSIX_FAULT_SHORT)
+    {
+        return HAL_SELFTEST_SHORT;
+    }
+    if(sensorFault[sensor] != HAL_POSIX_FAULT_OPEN)
+    {
+        *capFf = (HAL_POSIX_SENSOR_CAP_FF * sensorHeightUnits[sensor]) / 2u;
+    }
+    return HAL_SELFTEST_PASS;
+}
+
+/*******************************************************************************
+* Function Name: hal_posix_next_frame
+********************************************************************************
+* Summary:
+*  This function fills frame[] from the frame source, or with the default
+*  raw count if there is none.
+*
+*******************************************************************************/
+static void hal_posix_next_frame(void)
+{
+    if(NULL != frameSource)
+    {
+        frameSource(frame, MAX_SENSORS, frameSourceContext);
+    }
+    else
+    {
+        for(uint8_t i = 0; i < MAX_SENSORS; i++)
+        {
+            frame[i] = defaultRaw;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_scan_start
+********************************************************************************
+* Summary:
+*  This function produces the next frame from the frame source and converts
+*  it to 16-bit raw counts, clamped to the range of the CapSense middleware.
+*  The scan completes immediately, so the scan callback runs here.
+*
+*******************************************************************************/
+void hal_sensor_scan_start(void)
+{
+    hal_posix_next_frame();
+    for(uint8_t i = 0; i < MAX_SENSORS; i++)
+    {
+        frameRaw[i] = (frame[i] < 0) ? 0u : ((frame[i] > UINT16_MAX) ? UINT16_MAX : (uint16_t)frame[i]);
+    }
+
+    if(NULL != scanCallback)
+    {
+        scanCallback();
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_scan_one_start
+********************************************************************************
+* Summary:
+*  This function produces the next frame from the frame source and keeps
+*  only the raw count of one sensor. It does not count as a frame and does
+*  not call the scan callback.
+*
+*******************************************************************************/
+void hal_sensor_scan_one_start(uint8_t sensor)
+{
+    hal_posix_next_frame();
+    if(sensor < MAX_SENSORS)
+    {
+        frameRaw[sensor] = (frame[sensor] < 0) ? 0u :
+                           ((frame[sensor] > UINT16_MAX) ? UINT16_MAX : (uint16_t)frame[sensor]);
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_is_busy
+*******************************************************************************/
+uint8_t hal_sensor_is_busy(void)
+{
+    return HAL_SENSOR_NOT_BUSY;
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_process
+********************************************************************************
+* Summary:
+*  This function counts the frame. The application exits here once the frame
+*  limit has been processed.
+*
+*******************************************************************************/
+void hal_sensor_process(void)
+{
+    if((0u != frameLimit) && (frameCount >= frameLimit))
+    {
+        fflush(stdout);
+        exit(EXIT_SUCCESS);
+    }
+    frameCount++;
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_process_one
+*******************************************************************************/
+void hal_sensor_process_one(uint8_t sensor)
+{
+    (void)sensor;
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_get_view
+*******************************************************************************/
+hal_sensor_view_t hal_sensor_get_view(void)
+{
+    hal_sensor_view_t view;
+
+    view.raw = frameRaw;
+    view.stride = 1u;
+    return view;
+}
+
+/*******************************************************************************
+* Function Name: hal_sensor_set_scan_callback
+*******************************************************************************/
+void hal_sensor_set_scan_callback(hal_callback_t callback)
+{
+    scanCallback = callback;
+}
+
+/*******************************************************************************
+* Function Name: hal_alarm_init
+*******************************************************************************/
+void hal_alarm_init(void)
+{
+}
+
+/*******************************************************************************
+* Function Name: hal_alarm_write
+********************************************************************************
+* Summary:
+*  This function records the alarm outputs. The frame in the trace is the one
+*  whose scan has just completed, which the main loop processes next.
+*
+*******************************************************************************/
+void hal_alarm_write(uint8_t outputs)
+{
+    alarmOutputs = outputs;
+    if(0u != alarmTrace)
+    {
+        fprintf(stderr, "alarm,%lu,%lu,0x%X\n", (unsigned long)hal_time_ms(),
+                (unsigned long)(frameCount + 1u), (unsigned int)outputs);
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_uart_put
+*******************************************************************************/
+uint32_t hal_uart_put(uint32_t data)
+{
+    if(0u != uartMuted)
+    {
+        return 1u;
+    }
+    if(NULL != txSink)
+    {
+        txSink(data, txSinkContext);
+    }
+    else
+    {
+        putchar((int)data);
+    }
+    return 1u;
+}
+
+/*******************************************************************************
+* Function Name: hal_uart_put_string
+*******************************************************************************/
+void hal_uart_put_string(const char *string)
+{
+    if(NULL != txSink)
+    {
+        while('\0' != *string)
+        {
+            (void)hal_uart_put((uint8_t)*string++);
+        }
+    }
+    else if(0u == uartMuted)
+    {
+        fputs(string, stdout);
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_uart_get_num_in_rx
+********************************************************************************
+* Summary:
+*  This function reads one character ahead from the injected input or, if
+*  none has been set, from stdin.
+*
+*******************************************************************************/
+uint32_t hal_uart_get_num_in_rx(void)
+{
+    unsigned char c;
+    ssize_t result;
+
+    if((rxPending < 0) && (0u != rxSize))
+    {
+        rxPending = *rxData++;
+        rxSize--;
+    }
+    if((rxPending < 0) && (NULL == rxData) && (0u == rxEof))
+    {
+        result = read(STDIN_FILENO, &c, 1);
+        if(1 == result)
+        {
+            rxPending = c;
+        }
+        else if(0 == result)
+        {
+            rxEof = 1u;
+        }
+    }
+    return (rxPending < 0) ? 0u : 1u;
+}
+
+/*******************************************************************************
+* Function Name: hal_uart_get
+*******************************************************************************/
+uint32_t hal_uart_get(void)
+{
+    uint32_t data = 0u;
+
+    if(0u != hal_uart_get_num_in_rx())
+    {
+        data = (uint32_t)rxPending;
+        rxPending = -1;
+    }
+    return data;
+}
+
+/*******************************************************************************
+* Function Name: hal_uart_mute
+********************************************************************************
+* Summary:
+*  This function discards UART output while mute is non-zero, so that the
+*  cost of formatting can be measured without the transmit time.
+*
+*******************************************************************************/
+void hal_uart_mute(uint8_t mute)
+{
+    uartMuted = mute;
+}
+
+/*******************************************************************************
+* Function Name: hal_storage_init
+********************************************************************************
+* Summary:
+*  This function loads the EEPROM image from the storage file, if one is set
+*  and exists. A missing file reads as erased (zero) storage.
+*
+*******************************************************************************/
+uint32_t hal_storage_init(void)
+{
+    FILE *file;
+
+    memset(storage, 0, sizeof(storage));
+    if(NULL != storageFile)
+    {
+        file = fopen(storageFile, "rb");
+        if(NULL != file)
+        {
+            (void)fread(storage, 1, sizeof(storage), file);
+            fclose(file);
+        }
+    }
+    return HAL_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: hal_storage_read
+*******************************************************************************/
+uint32_t hal_storage_read(uint32_t addr, void *data, uint32_t size)
+{
+    if((addr > sizeof(storage)) || (size > sizeof(storage) - addr))
+    {
+        return HAL_ERROR;
+    }
+    memcpy(data, &storage[addr], size);
+    return HAL_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: hal_storage_write
+********************************************************************************
+* Summary:
+*  This function updates the EEPROM image and writes it through to the
+*  storage file.
+*
+*******************************************************************************/
+uint32_t hal_storage_write(uint32_t addr, const void *data, uint32_t size)
+{
+    FILE *file;
+
+    if((addr > sizeof(storage)) || (size > sizeof(storage) - addr))
+    {
+        return HAL_ERROR;
+    }
+    memcpy(&storage[addr], data, size);
+
+    if(NULL != storageFile)
+    {
+        file = fopen(storageFile, "wb");
+        if((NULL == file) || (sizeof(storage) != fwrite(storage, 1, sizeof(storage), file)))
+        {
+            if(NULL != file)
+            {
+                fclose(file);
+            }
+            return HAL_ERROR;
+        }
+        fclose(file);
+    }
+    return HAL_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: hal_log_load
+********************************************************************************
+* Summary:
+*  This function loads the log image on first use. A missing or short file
+*  reads as rows that were never written.
+*
+*******************************************************************************/
+static void hal_log_load(void)
+{
+    FILE *file;
+
+    if(0u == logLoaded)
+    {
+        logLoaded = 1u;
+        memset(logRows, 0, sizeof(logRows));
+        if(NULL != logFile)
+        {
+            file = fopen(logFile, "rb");
+            if(NULL != file)
+            {
+                (void)fread(logRows, 1, sizeof(logRows), file);
+                fclose(file);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_log_read
+*******************************************************************************/
+uint32_t hal_log_read(uint32_t row, void *data)
+{
+    if(row >= HAL_LOG_ROWS)
+    {
+        return HAL_ERROR;
+    }
+    hal_log_load();
+    memcpy(data, logRows[row], HAL_LOG_ROW_SIZE);
+    return HAL_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: hal_log_write
+********************************************************************************
+* Summary:
+*  This function updates one row of the log image and writes the whole image
+*  through to the log file.
+*
+*******************************************************************************/
+uint32_t hal_log_write(uint32_t row, const void *data)
+{
+    FILE *file;
+
+    if(row >= HAL_LOG_ROWS)
+    {
+        return HAL_ERROR;
+    }
+    hal_log_load();
+    memcpy(logRows[row], data, HAL_LOG_ROW_SIZE);
+
+    if(NULL != logFile)
+    {
+        file = fopen(logFile, "wb");
+        if((NULL == file) || (sizeof(logRows) != fwrite(logRows, 1, sizeof(logRows), file)))
+        {
+            if(NULL != file)
+            {
+                fclose(file);
+            }
+            return HAL_ERROR;
+        }
+        fclose(file);
+    }
+    return HAL_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: hal_delay_ms
+********************************************************************************
+* Summary:
+*  This function advances the virtual clock, and sleeps in realtime mode.
+*
+*******************************************************************************/
+void hal_delay_ms(uint32_t ms)
+{
+    struct timespec delay;
+
+    virtualMs += ms;
+    if(0u != realtime)
+    {
+        fflush(stdout);
+        delay.tv_sec = ms / 1000u;
+        delay.tv_nsec = (long)(ms % 1000u) * 1000000L;
+        nanosleep(&delay, NULL);
+    }
+}
+
+/*******************************************************************************
+* Function Name: hal_time_ms
+*******************************************************************************/
+uint32_t hal_time_ms(void)
+{
+    return virtualMs;
+}
+
+/*******************************************************************************
+* Function Name: hal_timer_ticks
+********************************************************************************
+* Summary:
+*  This function returns a free running nanosecond counter.
+*
+*******************************************************************************/
+uint32_t hal_timer_ticks(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+}
+
+/*******************************************************************************
+* Function Name: hal_timer_ticks_per_us
+*******************************************************************************/
+uint32_t hal_timer_ticks_per_us(void)
+{
+    return 1000u;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,96 @@
+/*******************************************************************************
+* File Name: hal_posix.h
+*
+* Description: This file is the public interface of hal_posix.c source file.
+*              It configures the stand-ins used by the host build.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef HOST_HAL_POSIX_H_
+#define HOST_HAL_POSIX_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Size of the emulated EEPROM image in bytes (one PSoC 4 flash row) */
+#define HAL_POSIX_STORAGE_SIZE      (256u)
+
+/* Raw count reported by the default frame source */
+#define HAL_POSIX_DEFAULT_RAW       (500)
+
+/* Self-test: capacitance of a middle sensor and duration of each test */
+#define HAL_POSIX_SENSOR_CAP_FF     (12000u)
+#define HAL_POSIX_SELF_TEST_MS      (3u)
+
+/* Faults reported by the self-test, see hal_posix_set_sensor_fault() */
+#define HAL_POSIX_FAULT_NONE        (0u)
+#define HAL_POSIX_FAULT_SHORT       (1u)    /* Pin short */
+#define HAL_POSIX_FAULT_OPEN        (2u)    /* Electrode not connected, no capacitance */
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Produces one frame of raw counts each time a scan is started */
+typedef void (*hal_posix_frame_source_t)(int32_t *raw, uint8_t count, void *context);
+
+/* Receives every character the application transmits */
+typedef void (*hal_posix_tx_sink_t)(uint32_t data, void *context);
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void hal_posix_set_frame_source(hal_posix_frame_source_t source, void *context);
+void hal_posix_set_default_raw(int32_t raw);
+void hal_posix_set_frame_limit(uint32_t frames);
+void hal_posix_set_storage_file(const char *path);
+void hal_posix_set_log_file(const char *path);
+void hal_posix_set_realtime(uint8_t enable);
+uint32_t hal_posix_frame_count(void);
+void hal_posix_set_tx_sink(hal_posix_tx_sink_t sink, void *context);
+void hal_posix_set_rx_data(const uint8_t *data, size_t size);
+void hal_posix_set_sensor_fault(uint8_t sensor, uint8_t fault);
+void hal_posix_set_alarm_trace(uint8_t enable);
+uint8_t hal_posix_alarm_outputs(void);
+
+#endif /* HOST_HAL_POSIX_H_ */
+
+
+/* [] END OF FILE  */
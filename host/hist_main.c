@@ -0,0 +1,187 @@
+/*******************************************************************************
+* File Name: hist_main.c
+*
+* Description: This file is the entry point of lls_hist. It finds a binary
+*              history download in a UART capture, checks its CRC and prints the
+*              records in CSV format.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "history.h"
+#include "crc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint8_t *read_file(const char *path, size_t *size);
+static uint32_t get_le(const uint8_t *p, uint8_t bytes);
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Decodes the first download in the capture and prints
+*    TimeMs,LevelMm,SenActCnt
+*  one row per record, oldest first. The exit code is non-zero if no complete
+*  download is found or the CRC does not match.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint8_t *data;
+    const uint8_t *p = NULL;
+    size_t size;
+    size_t i;
+    uint16_t count;
+    uint32_t newestMs;
+    uint32_t *timeMs;
+    uint32_t record;
+
+    if(argc != 2)
+    {
+        fprintf(stderr, "usage: %s CAPTURE\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    data = read_file(argv[1], &size);
+    if(NULL == data)
+    {
+        return EXIT_FAILURE;
+    }
+
+    /* Text output may precede the download */
+    for(i = 0u; (i + HISTORY_HEADER_SIZE) <= size; i++)
+    {
+        if(0 == memcmp(&data[i], HISTORY_MAGIC, 4u))
+        {
+            p = &data[i];
+            break;
+        }
+    }
+    if((NULL == p) || (HISTORY_VERSION != p[4]) || (sizeof(uint32_t) != p[5]))
+    {
+        fprintf(stderr, "%s: no history download found\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    count = (uint16_t)get_le(&p[6], 2u);
+    newestMs = get_le(&p[8], 4u);
+    if((size_t)(&data[size] - p) < (HISTORY_HEADER_SIZE + (count * 4u) + 2u))
+    {
+        fprintf(stderr, "%s: download truncated\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    if(crc16_block(CRC16_INIT, &p[4], HISTORY_HEADER_SIZE - 4u + (count * 4u)) !=
+       get_le(&p[HISTORY_HEADER_SIZE + (count * 4u)], 2u))
+    {
+        fprintf(stderr, "%s: CRC mismatch\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    /* Rebuild full times backwards from the newest record */
+    timeMs = malloc((count + 1u) * sizeof(uint32_t));
+    if(NULL == timeMs)
+    {
+        return EXIT_FAILURE;
+    }
+    p += HISTORY_HEADER_SIZE;
+    for(i = count; i > 0u; i--)
+    {
+        record = get_le(&p[(i - 1u) * 4u], 4u);
+        if(i == count)
+        {
+            timeMs[i - 1u] = newestMs;
+        }
+        else
+        {
+            timeMs[i - 1u] = timeMs[i] - (uint16_t)((get_le(&p[i * 4u], 4u) >> HISTORY_TIME_POS) -
+                                                    (record >> HISTORY_TIME_POS)) * HISTORY_TICK_MS;
+        }
+    }
+
+    printf("TimeMs,LevelMm,SenActCnt\n");
+    for(i = 0u; i < count; i++)
+    {
+        record = get_le(&p[i * 4u], 4u);
+        printf("%u,%.1f,%u\n", (unsigned)timeMs[i],
+               ((record & HISTORY_LEVEL_MASK) >> HISTORY_LEVEL_POS) / 10.0,
+               (unsigned)(record & HISTORY_COUNT_MASK));
+    }
+    free(timeMs);
+    free(data);
+    return EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: read_file
+*******************************************************************************/
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t *data;
+    long length;
+
+    if(NULL == file)
+    {
+        perror(path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data = malloc((length > 0) ? (size_t)length : 1u);
+    *size = (NULL == data) ? 0u : fread(data, 1u, (size_t)length, file);
+    fclose(file);
+    return data;
+}
+
+/*******************************************************************************
+* Function Name: get_le
+*******************************************************************************/
+static uint32_t get_le(const uint8_t *p, uint8_t bytes)
+{
+    uint32_t value = 0u;
+
+    while(bytes-- > 0u)
+    {
+        value = (value << 8) | p[bytes];
+    }
+    return value;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,200 @@
+/*******************************************************************************
+* File Name: host_main.c
+*
+* Description: This file is the entry point of the host build. It parses the
+*              command line, configures the POSIX stand-ins and runs the
+*              unmodified application loop from main.c.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal_posix.h"
+#include "tank_sim.h"
+#include "sensor_table.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+/* main() of main.c, renamed by the host Makefile */
+int lls_app_main(void);
+
+static void usage(const char *name);
+static int parse_fault(const char *spec);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static tank_sim_t sim;
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Host entrance point. Commands typed on stdin are handled like UART input.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    tank_sim_config_t config;
+    const char *script = NULL;
+
+    tank_sim_default_config(&config);
+
+    for(int i = 1; i < argc; i++)
+    {
+        if((i + 1 < argc) && tank_sim_parse_option(&config, argv[i], argv[i + 1]))
+        {
+            i++;
+        }
+        else if((0 == strcmp(argv[i], "--sim")) && (i + 1 < argc))
+        {
+            script = argv[++i];
+        }
+        else if((0 == strcmp(argv[i], "--frames")) && (i + 1 < argc))
+        {
+            hal_posix_set_frame_limit((uint32_t)strtoul(argv[++i], NULL, 0));
+        }
+        else if((0 == strcmp(argv[i], "--raw")) && (i + 1 < argc))
+        {
+            hal_posix_set_default_raw((int32_t)strtol(argv[++i], NULL, 0));
+        }
+        else if((0 == strcmp(argv[i], "--storage")) && (i + 1 < argc))
+        {
+            hal_posix_set_storage_file(argv[++i]);
+        }
+        else if((0 == strcmp(argv[i], "--log")) && (i + 1 < argc))
+        {
+            hal_posix_set_log_file(argv[++i]);
+        }
+        else if(0 == strcmp(argv[i], "--realtime"))
+        {
+            hal_posix_set_realtime(1u);
+        }
+        else if((0 == strcmp(argv[i], "--fault")) && (i + 1 < argc))
+        {
+            if(0 != parse_fault(argv[++i]))
+            {
+                fprintf(stderr, "Invalid fault: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if(0 == strcmp(argv[i], "--alarm-trace"))
+        {
+            hal_posix_set_alarm_trace(1u);
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Feed the application from the tank model instead of constant counts */
+    if(NULL != script)
+    {
+        tank_sim_init(&sim, &config);
+        if(0 != tank_sim_set_script(&sim, script))
+        {
+            fprintf(stderr, "Invalid level script: %s\n", script);
+            return EXIT_FAILURE;
+        }
+        hal_posix_set_frame_source(tank_sim_frame_source, &sim);
+    }
+
+    return lls_app_main();
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --frames N       Exit after N frames (default: run forever)\n"
+            "  --raw N          Raw count of the constant frame source\n"
+            "  --storage FILE   File backing the emulated EEPROM\n"
+            "  --log FILE       File backing the flash log rows\n"
+            "  --realtime       Sleep in delays instead of using a virtual clock\n"
+            "  --fault S:KIND   Make the self-test of sensor S report KIND, short or open.\n"
+            "                   Repeatable\n"
+            "  --alarm-trace    Print alarm output changes to stderr as\n"
+            "                   alarm,timeMs,frame,outputs\n"
+            "  --sim SCRIPT     Generate frames from the tank model along a level\n"
+            "                   trajectory of timeMs:levelMm points, e.g. 0:0,10000:153\n",
+            name);
+    tank_sim_print_options(stderr);
+}
+
+/*******************************************************************************
+* Function Name: parse_fault
+********************************************************************************
+* Summary:
+*  This function parses a SENSOR:KIND fault option.
+*
+* Return:
+*  0 on success, -1 if the option is not valid.
+*
+*******************************************************************************/
+static int parse_fault(const char *spec)
+{
+    char *end;
+    unsigned long sensor = strtoul(spec, &end, 10);
+
+    if((end == spec) || (*end != ':') || (sensor >= SENSOR_COUNT))
+    {
+        return -1;
+    }
+    if(0 == strcmp(end + 1, "short"))
+    {
+        hal_posix_set_sensor_fault((uint8_t)sensor, HAL_POSIX_FAULT_SHORT);
+    }
+    else if(0 == strcmp(end + 1, "open"))
+    {
+        hal_posix_set_sensor_fault((uint8_t)sensor, HAL_POSIX_FAULT_OPEN);
+    }
+    else
+    {
+        return -1;
+    }
+    return 0;
+}
+
+
+/* [] END OF FILE */
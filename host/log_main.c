@@ -0,0 +1,208 @@
+/*******************************************************************************
+* File Name: log_main.c
+*
+* Description: This file is the entry point of lls_log. It finds a flash log
+*              download in a UART capture, checks the CRC of every row and prints the
+*              decoded records in CSV format.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "datalog.h"
+#include "crc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint8_t *read_file(const char *path, size_t *size);
+static uint32_t decode_row(datalog_row_t *row, uint32_t fromS, uint32_t toS);
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Decodes the first download in the capture and prints
+*    TimeS,LevelMm,Boot
+*  one row per record from FROM to TO seconds of log time. Boot is 1 on the
+*  first record after a restart of the logger. The exit code is non-zero if
+*  no download is found, it is truncated or a row has a bad CRC.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint8_t *data;
+    const uint8_t *p = NULL;
+    size_t size;
+    size_t i;
+    uint16_t rows;
+    uint32_t fromS = 0u;
+    uint32_t toS = UINT32_MAX;
+    uint32_t bad = 0u;
+    datalog_row_t row;
+
+    if((argc < 2) || (argc > 4))
+    {
+        fprintf(stderr, "usage: %s CAPTURE [FROM [TO]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if(argc > 2)
+    {
+        fromS = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+    if(argc > 3)
+    {
+        toS = (uint32_t)strtoul(argv[3], NULL, 0);
+    }
+    data = read_file(argv[1], &size);
+    if(NULL == data)
+    {
+        return EXIT_FAILURE;
+    }
+
+    /* Text output may precede the download */
+    for(i = 0u; (i + 8u) <= size; i++)
+    {
+        if(0 == memcmp(&data[i], DATALOG_MAGIC, 4u))
+        {
+            p = &data[i];
+            break;
+        }
+    }
+    if((NULL == p) || (DATALOG_VERSION != p[4]) || (sizeof(datalog_row_t) != p[5]))
+    {
+        fprintf(stderr, "%s: no log download found\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    rows = (uint16_t)(p[6] | (p[7] << 8));
+    p += 8u;
+    if((size_t)(&data[size] - p) < (rows * sizeof(datalog_row_t)))
+    {
+        fprintf(stderr, "%s: download truncated\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    printf("TimeS,LevelMm,Boot\n");
+    for(i = 0u; i < rows; i++)
+    {
+        memcpy(&row, &p[i * sizeof(row)], sizeof(row));
+        bad += decode_row(&row, fromS, toS);
+    }
+    free(data);
+    if(0u != bad)
+    {
+        fprintf(stderr, "%s: %u rows with bad CRC\n", argv[1], (unsigned)bad);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: decode_row
+********************************************************************************
+* Summary:
+*  Prints the records of one row within the time range. Returns 1 if the row
+*  is damaged, 0 otherwise.
+*
+*******************************************************************************/
+static uint32_t decode_row(datalog_row_t *row, uint32_t fromS, uint32_t toS)
+{
+    uint16_t crc = row->crc;
+    int32_t level = row->firstLevel;
+    uint32_t zigzag;
+    uint32_t used = 0u;
+    uint32_t timeS;
+
+    row->crc = 0u;
+    if(crc != crc16_block(CRC16_INIT, row, sizeof(*row)))
+    {
+        return 1u;
+    }
+    for(uint32_t n = 0u; n < row->count; n++)
+    {
+        if(n > 0u)
+        {
+            if(used >= DATALOG_DATA_SIZE)
+            {
+                return 1u;
+            }
+            zigzag = row->data[used++];
+            if(0u != (zigzag & 0x80u))
+            {
+                if(used >= DATALOG_DATA_SIZE)
+                {
+                    return 1u;
+                }
+                zigzag = ((zigzag & 0x7Fu) << 8) | row->data[used++];
+            }
+            level += (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1u);
+        }
+        timeS = row->startTimeS + (n * row->periodS);
+        if((timeS >= fromS) && (timeS <= toS))
+        {
+            printf("%u,%.1f,%u\n", (unsigned)timeS, level / 10.0,
+                   ((n == 0u) && (0u != (row->flags & DATALOG_FLAG_BOOT))) ? 1u : 0u);
+        }
+    }
+    return 0u;
+}
+
+/*******************************************************************************
+* Function Name: read_file
+*******************************************************************************/
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t *data;
+    long length;
+
+    if(NULL == file)
+    {
+        perror(path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data = malloc((length > 0) ? (size_t)length : 1u);
+    *size = (NULL == data) ? 0u : fread(data, 1u, (size_t)length, file);
+    fclose(file);
+    return data;
+}
+
+/* [] END OF FILE */
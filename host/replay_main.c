@@ -0,0 +1,457 @@
+/*******************************************************************************
+* File Name: replay_main.c
+*
+* Description: This file is the entry point of lls_replay. It feeds the raw
+*              counts of captured 'csv' mode logs through the firmware level
+*              pipeline and diffs the recomputed values against the log.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "level.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Raw, Diff and Proc per sensor, then SenActCnt, Level% and LevelMm */
+#define CSV_FIELDS          (3u * NUMSENSORS + 3u)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* One parsed 'csv' row. Level% and LevelMm are kept as whole and tenths. */
+typedef struct
+{
+    int32_t raw[NUMSENSORS];
+    int32_t diff[NUMSENSORS];
+    int32_t proc[NUMSENSORS];
+    int32_t activeCount;
+    int32_t percent[2];
+    int32_t mm[2];
+} csv_row_t;
+
+/* Mismatch counters */
+typedef struct
+{
+    uint32_t rows;
+    uint32_t skipped;
+    uint32_t diff;
+    uint32_t proc;
+    uint32_t activeCount;
+    uint32_t percent;
+    uint32_t mm;
+    uint32_t badRows;
+} replay_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint32_t maxReport = 10u;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int replay_file(const char *path, replay_stats_t *stats);
+static uint8_t parse_row(const char *p, const char *end, csv_row_t *row);
+static uint8_t parse_cal(const char *p, const char *end);
+static const char *parse_int(const char *p, const char *end, int32_t *value);
+static uint8_t check_row(const csv_row_t *row, replay_stats_t *stats);
+static void usage(const char *name);
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Replays every file given on the command line and prints a key=value
+*  summary. The exit code is non-zero if any row differs from the log.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    replay_stats_t stats;
+    struct timespec start;
+    struct timespec stop;
+    double elapsed;
+    uint32_t files = 0u;
+
+    memset(&stats, 0, sizeof(stats));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(int i = 1; i < argc; i++)
+    {
+        if((0 == strcmp(argv[i], "--max-report")) && (i + 1 < argc))
+        {
+            maxReport = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if('-' == argv[i][0])
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else
+        {
+            if(0 != replay_file(argv[i], &stats))
+            {
+                return EXIT_FAILURE;
+            }
+            files++;
+        }
+    }
+    if(0u == files)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    elapsed = (double)(stop.tv_sec - start.tv_sec) + (double)(stop.tv_nsec - start.tv_nsec) * 1e-9;
+
+    printf("files=%u\n", files);
+    printf("rows=%u\n", stats.rows);
+    printf("skipped_lines=%u\n", stats.skipped);
+    printf("mismatch_rows=%u\n", stats.badRows);
+    printf("mismatch_diff=%u\n", stats.diff);
+    printf("mismatch_proc=%u\n", stats.proc);
+    printf("mismatch_senactcnt=%u\n", stats.activeCount);
+    printf("mismatch_level_percent=%u\n", stats.percent);
+    printf("mismatch_level_mm=%u\n", stats.mm);
+    printf("rows_per_second=%.0f\n", (elapsed > 0.0) ? (double)stats.rows / elapsed : 0.0);
+
+    return (0u == stats.badRows) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*******************************************************************************
+* Function Name: replay_file
+********************************************************************************
+* Summary:
+*  This function maps a capture and replays it line by line. Lines that are
+*  not 'csv' rows (banner, 'basic' output, echoed commands) are skipped.
+*  "EmptyCal=" lines load new empty offsets, as printed by a 'cal' command
+*  before the row it applies to. Until the first such line the offsets are
+*  recovered from the first row as Raw - Diff.
+*
+*******************************************************************************/
+static int replay_file(const char *path, replay_stats_t *stats)
+{
+    struct stat info;
+    const char *data;
+    const char *p;
+    const char *end;
+    uint8_t haveOffsets = 0u;
+    uint32_t line = 0u;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if((fd < 0) || (0 != fstat(fd, &info)))
+    {
+        perror(path);
+        return -1;
+    }
+    if(0 == info.st_size)
+    {
+        close(fd);
+        return 0;
+    }
+    data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(MAP_FAILED == data)
+    {
+        perror(path);
+        return -1;
+    }
+    (void)posix_madvise((void *)data, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+
+    p = data;
+    end = data + info.st_size;
+    while(p < end)
+    {
+        const char *eol = memchr(p, '\n', (size_t)(end - p));
+        csv_row_t row;
+
+        if(NULL == eol)
+        {
+            eol = end;
+        }
+        line++;
+
+        if(0u != parse_row(p, eol, &row))
+        {
+            if(0u == haveOffsets)
+            {
+                for(uint8_t i = 0; i < NUMSENSORS; i++)
+                {
+                    sensorEmptyOffset[i] = (uint16_t)(row.raw[i] - row.diff[i]);
+                }
+                level_update_thresholds();
+                haveOffsets = 1u;
+            }
+            for(uint8_t i = 0; i < NUMSENSORS; i++)
+            {
+                sensorRaw[i] = (uint16_t)row.raw[i];
+            }
+            level_process_frame();
+
+            stats->rows++;
+            if(0u != check_row(&row, stats))
+            {
+                if(stats->badRows++ < maxReport)
+                {
+                    printf("%s:%u: logged cnt=%d %d.%d%% %d.%dmm, replayed cnt=%u %d.%d%% %d.%dmm\n",
+                           path, line, row.activeCount,
+                           row.percent[0], row.percent[1], row.mm[0], row.mm[1],
+                           sensorActiveCount,
+                           levelPercent >> 8, ((levelPercent & 0xFF) * 10) >> 8,
+                           levelMm >> 8, ((levelMm & 0xFF) * 10) >> 8);
+                }
+            }
+        }
+        else if(0u != parse_cal(p, eol))
+        {
+            haveOffsets = 1u;
+        }
+        else
+        {
+            stats->skipped++;
+        }
+        p = eol + 1;
+    }
+
+    munmap((void *)data, (size_t)info.st_size);
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: parse_int
+********************************************************************************
+* Summary:
+*  This function parses an optionally negative decimal integer.
+*
+* Return:
+*  Pointer past the number, or NULL if there are no digits.
+*
+*******************************************************************************/
+static const char *parse_int(const char *p, const char *end, int32_t *value)
+{
+    int32_t sign = 1;
+    int32_t result = 0;
+    const char *digits;
+
+    if((p < end) && ('-' == *p))
+    {
+        sign = -1;
+        p++;
+    }
+    digits = p;
+    while((p < end) && ((uint8_t)(*p - '0') <= 9u))
+    {
+        result = result * 10 + (*p - '0');
+        p++;
+    }
+    *value = sign * result;
+    return (p == digits) ? NULL : p;
+}
+
+/*******************************************************************************
+* Function Name: parse_row
+********************************************************************************
+* Summary:
+*  This function parses a 'csv' data row as printed by
+*  display_cur_liquid_level().
+*
+* Return:
+*  1 if the line is a complete row, 0 otherwise.
+*
+*******************************************************************************/
+static uint8_t parse_row(const char *p, const char *end, csv_row_t *row)
+{
+    int32_t *ints[3] = {row->raw, row->diff, row->proc};
+    int32_t *fixed[2] = {row->percent, row->mm};
+
+    for(uint8_t group = 0; group < 3u; group++)
+    {
+        for(uint8_t i = 0; i < NUMSENSORS; i++)
+        {
+            p = parse_int(p, end, &ints[group][i]);
+            if((NULL == p) || (p >= end) || (',' != *p))
+            {
+                return 0u;
+            }
+            p++;
+        }
+    }
+    p = parse_int(p, end, &row->activeCount);
+    if((NULL == p) || (p >= end) || (',' != *p))
+    {
+        return 0u;
+    }
+    p++;
+    for(uint8_t i = 0; i < 2u; i++)
+    {
+        p = parse_int(p, end, &fixed[i][0]);
+        if((NULL == p) || (p >= end) || ('.' != *p))
+        {
+            return 0u;
+        }
+        p = parse_int(p + 1, end, &fixed[i][1]);
+        if(NULL == p)
+        {
+            return 0u;
+        }
+        if((0u == i) && ((p >= end) || (',' != *p++)))
+        {
+            return 0u;
+        }
+    }
+    /* Only the line terminator may follow */
+    while((p < end) && (('\r' == *p) || (' ' == *p)))
+    {
+        p++;
+    }
+    return (p == end) ? 1u : 0u;
+}
+
+/*******************************************************************************
+* Function Name: parse_cal
+********************************************************************************
+* Summary:
+*  This function loads sensorEmptyOffset[] from an "EmptyCal=" line.
+*
+* Return:
+*  1 if the line held a complete set of offsets, 0 otherwise.
+*
+*******************************************************************************/
+static uint8_t parse_cal(const char *p, const char *end)
+{
+    static const char tag[] = "EmptyCal=";
+    int32_t offset[NUMSENSORS];
+
+    if(((size_t)(end - p) < sizeof(tag) - 1u) || (0 != memcmp(p, tag, sizeof(tag) - 1u)))
+    {
+        return 0u;
+    }
+    p += sizeof(tag) - 1u;
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        p = parse_int(p, end, &offset[i]);
+        if((NULL == p) || (p >= end) || (',' != *p))
+        {
+            return 0u;
+        }
+        p++;
+    }
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        sensorEmptyOffset[i] = (uint16_t)offset[i];
+    }
+    level_update_thresholds();
+    return 1u;
+}
+
+/*******************************************************************************
+* Function Name: check_row
+********************************************************************************
+* Summary:
+*  This function compares the replayed pipeline state with a logged row.
+*  Level% and LevelMm are compared after the same one decimal formatting
+*  that display_decimal_fixed_val() applies.
+*
+* Return:
+*  1 if any value differs, 0 otherwise.
+*
+*******************************************************************************/
+static uint8_t check_row(const csv_row_t *row, replay_stats_t *stats)
+{
+    uint8_t bad = 0u;
+    uint8_t diffBad = 0u;
+    uint8_t procBad = 0u;
+
+    level_require_processed();
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        diffBad |= (row->diff[i] != level_sensor_diff(i)) ? 1u : 0u;
+        procBad |= (row->proc[i] != sensorProcessed[i]) ? 1u : 0u;
+    }
+    if(0u != diffBad)
+    {
+        stats->diff++;
+        bad = 1u;
+    }
+    if(0u != procBad)
+    {
+        stats->proc++;
+        bad = 1u;
+    }
+    if(row->activeCount != sensorActiveCount)
+    {
+        stats->activeCount++;
+        bad = 1u;
+    }
+    if((row->percent[0] != (levelPercent >> 8)) ||
+       (row->percent[1] != (((levelPercent & 0xFF) * 10) >> 8)))
+    {
+        stats->percent++;
+        bad = 1u;
+    }
+    if((row->mm[0] != (levelMm >> 8)) ||
+       (row->mm[1] != (((levelMm & 0xFF) * 10) >> 8)))
+    {
+        stats->mm++;
+        bad = 1u;
+    }
+    return bad;
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [--max-report N] capture.csv...\n"
+            "  --max-report N   Print at most N mismatching rows (default 10)\n",
+            name);
+}
+
+
+/* [] END OF FILE */
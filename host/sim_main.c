@@ -0,0 +1,280 @@
+/*******************************************************************************
+* File Name: sim_main.c
+*
+* Description: This file is the entry point of lls_sim. It runs the firmware
+*              level pipeline on frames from the tank model as fast as
+*              possible and reports level accuracy and throughput.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "level.h"
+#include "wall.h"
+#include "tilt.h"
+#include "edge.h"
+#include "tank_sim.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void usage(const char *name);
+static double now_s(void);
+static uint16_t clamp_raw(int32_t value);
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  The empty offsets are taken from the noise free dry probe, as after a 'cal'
+*  command on an empty container. Each frame is then processed with
+*  level_process_frame() and compared with the true level of the model.
+*  With --wall-comp, the scales are compensated for the wall of the model as
+*  the 'wall' command does, and with --tilt the level is the tilt-aware
+*  estimate as after 'tilt on'. With --lazy the frames are processed in lazy
+*  mode with the given noise band, as after 'lazy on', and with --edge the
+*  level is taken at the largest rise between adjacent sensors as after
+*  'edge on'. Results are printed as
+*  key=value lines, and the exit status fails if the mean absolute error
+*  exceeds --max-error.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static tank_sim_t sim;
+    tank_sim_config_t config;
+    int32_t raw[NUMSENSORS];
+    const char *script = "0:0,60000:153,120000:0";
+    uint32_t frames = 1200u;
+    uint8_t trace = 0u;
+    uint8_t wallComp = 0u;
+    int32_t lazyBand = -1;
+    double sumSpread = 0.0;
+    double maxError = -1.0;
+    static int16_t scale[NUMSENSORS];
+    double sumAbs = 0.0;
+    double sumSq = 0.0;
+    double maxAbs = 0.0;
+    double start;
+    double elapsed;
+
+    tank_sim_default_config(&config);
+
+    for(int i = 1; i < argc; i++)
+    {
+        if((i + 1 < argc) && tank_sim_parse_option(&config, argv[i], argv[i + 1]))
+        {
+            i++;
+        }
+        else if((0 == strcmp(argv[i], "--sim")) && (i + 1 < argc))
+        {
+            script = argv[++i];
+        }
+        else if((0 == strcmp(argv[i], "--frames")) && (i + 1 < argc))
+        {
+            frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if(0 == strcmp(argv[i], "--trace"))
+        {
+            trace = 1u;
+        }
+        else if(0 == strcmp(argv[i], "--tilt"))
+        {
+            tiltEnable = 1u;
+        }
+        else if(0 == strcmp(argv[i], "--edge"))
+        {
+            edgeEnable = 1u;
+        }
+        else if((0 == strcmp(argv[i], "--lazy")) && (i + 1 < argc))
+        {
+            lazyBand = (int32_t)strtol(argv[++i], NULL, 0);
+        }
+        else if(0 == strcmp(argv[i], "--wall-comp"))
+        {
+            wallComp = 1u;
+        }
+        else if((0 == strcmp(argv[i], "--max-error")) && (i + 1 < argc))
+        {
+            maxError = strtod(argv[++i], NULL);
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    tank_sim_init(&sim, &config);
+    if(0 != tank_sim_set_script(&sim, script))
+    {
+        fprintf(stderr, "Invalid level script: %s\n", script);
+        return EXIT_FAILURE;
+    }
+    if(0u != wallComp)
+    {
+        wall_compute_scales((uint8_t)lrintf(config.wallMm * 10.0f), (uint8_t)lrintf(config.wallEps * 10.0f), scale);
+        sensorScale = scale;
+    }
+    tank_sim_baseline(&sim, raw, NUMSENSORS);
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        sensorEmptyOffset[i] = clamp_raw(raw[i]);
+    }
+    level_update_thresholds();
+    if(lazyBand >= 0)
+    {
+        level_set_lazy(1u, (uint16_t)lazyBand);
+    }
+
+    if(0u != trace)
+    {
+        printf("TimeMs,TrueMm,SenActCnt,LevelMm\n");
+    }
+
+    start = now_s();
+    for(uint32_t frame = 0; frame < frames; frame++)
+    {
+        uint32_t timeMs = sim.timeMs;
+        double trueMm = tank_sim_level_mm(&sim);
+        double error;
+
+        tank_sim_next_frame(&sim, raw, NUMSENSORS);
+        for(uint8_t i = 0; i < NUMSENSORS; i++)
+        {
+            sensorRaw[i] = clamp_raw(raw[i]);
+        }
+        if(0u != levelLazy)
+        {
+            level_process_frame_lazy();
+        }
+        else
+        {
+            level_process_frame();
+        }
+        edge_process_frame();
+        tilt_process_frame();
+        if(tiltEnable == 0u)
+        {
+            tilt_estimate();
+        }
+        sumSpread += (double)tiltSpreadMm / 256.0;
+
+        error = (double)levelMm / 256.0 - trueMm;
+        sumAbs += fabs(error);
+        sumSq += error * error;
+        if(fabs(error) > maxAbs)
+        {
+            maxAbs = fabs(error);
+        }
+        if(0u != trace)
+        {
+            printf("%u,%.2f,%u,%.2f\n", timeMs, trueMm, sensorActiveCount, (double)levelMm / 256.0);
+        }
+    }
+    elapsed = now_s() - start;
+
+    if(0u == trace)
+    {
+        printf("frames=%u\n", frames);
+        printf("seconds=%.6f\n", elapsed);
+        printf("frames_per_second=%.0f\n", (elapsed > 0.0) ? (double)frames / elapsed : 0.0);
+        printf("mean_abs_error_mm=%.3f\n", (frames > 0u) ? sumAbs / frames : 0.0);
+        printf("rms_error_mm=%.3f\n", (frames > 0u) ? sqrt(sumSq / frames) : 0.0);
+        printf("max_abs_error_mm=%.3f\n", maxAbs);
+        printf("mean_spread_mm=%.3f\n", (frames > 0u) ? sumSpread / frames : 0.0);
+        if(0u != levelLazy)
+        {
+            printf("lazy_avoided_frames=%u\n", levelLazyAvoided);
+        }
+    }
+    if((maxError >= 0.0) && (frames > 0u) && (sumAbs / frames > maxError))
+    {
+        fprintf(stderr, "Mean absolute error %.3f mm exceeds %.3f mm\n", sumAbs / frames, maxError);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: now_s
+*******************************************************************************/
+static double now_s(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/*******************************************************************************
+* Function Name: clamp_raw
+********************************************************************************
+* Summary:
+*  This function limits a simulated count to the 16-bit raw count range.
+*
+*******************************************************************************/
+static uint16_t clamp_raw(int32_t value)
+{
+    return (value < 0) ? 0u : ((value > UINT16_MAX) ? UINT16_MAX : (uint16_t)value);
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --sim SCRIPT     Level trajectory of timeMs:levelMm points\n"
+            "                   (default 0:0,60000:153,120000:0)\n"
+            "  --frames N       Number of frames to run (default 1200)\n"
+            "  --trace          Print one CSV line per frame instead of a summary\n"
+            "  --tilt           Report the tilt-aware level instead of the submerged count\n"
+            "  --edge           Report the level at the largest rise between adjacent sensors\n"
+            "  --lazy BAND      Process the frames in lazy mode with a noise band of BAND raw counts\n"
+            "  --wall-comp      Compensate the scales for the wall of the model\n"
+            "  --max-error MM   Fail if the mean absolute error exceeds MM\n",
+            name);
+    tank_sim_print_options(stderr);
+}
+
+
+/* [] END OF FILE */
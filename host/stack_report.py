@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+################################################################################
+# \file stack_report.py
+# \version 1.0
+#
+# \brief
+# Worst-case stack depth report from the call graph files that GCC writes
+# with -fcallgraph-info=su (one .ci file per translation unit). For each root
+# (the main thread and every interrupt handler) it finds the deepest call
+# path, then stacks one handler per distinct interrupt priority on top of the
+# main thread, each with its exception frame, as interrupts nest on one stack.
+#
+#   stack_report.py [options] CI_FILE_OR_DIR...
+#
+#   --root NAME          Main thread entry point (default main)
+#   --isr NAME:PRIORITY  Interrupt handler and its NVIC priority; a lower
+#                        number preempts a higher one. Repeatable
+#   --frame BYTES        Stack taken by the hardware per exception entry
+#                        (default 36: 8 word frame plus alignment padding)
+#   --call CALLER=CALLEE Add a call the compiler cannot see, such as a
+#                        function pointer or a vector table entry. Repeatable
+#   --assume NAME=BYTES  Worst stack of a function without call graph
+#                        information, such as a library or assembly function.
+#                        Repeatable
+#   --budget BYTES       Exit 1 if the total exceeds BYTES
+#   --top N              Number of functions listed (default 25)
+#
+################################################################################
+# \copyright
+# Copyright 2018-2023, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import os
+import re
+import sys
+
+NODE_RE = re.compile(r'^node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE_RE = re.compile(r'^edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+STACK_RE = re.compile(r'\\n(\d+) bytes \(([a-z,]+)\)')
+INDIRECT = '__indirect_call'
+
+
+class CallGraph:
+    def __init__(self):
+        self.stack = {}        # title -> (bytes, qualifier)
+        self.calls = {}        # title -> set of titles
+        self.defined = set()   # titles with a body in some .ci file
+
+    def load(self, path):
+        with open(path) as f:
+            for line in f:
+                node = NODE_RE.match(line)
+                if node:
+                    title, label = node.groups()
+                    self.calls.setdefault(title, set())
+                    usage = STACK_RE.search(label)
+                    if usage:
+                        self.stack[title] = (int(usage.group(1)), usage.group(2))
+                        self.defined.add(title)
+                    continue
+                edge = EDGE_RE.match(line)
+                if edge:
+                    self.calls.setdefault(edge.group(1), set()).add(edge.group(2))
+
+    def resolve(self, name):
+        """Map a plain function name to its title; static ones are FILE:NAME."""
+        if name in self.calls:
+            return name
+        matches = [t for t in self.calls if t.split(':')[-1] == name]
+        return matches[0] if len(matches) == 1 else None
+
+
+def analyse(graph, assume):
+    """Return worst depth, deepest path and the set of problems per function."""
+    memo = {}
+    active = set()
+
+    def visit(title):
+        if title in memo:
+            return memo[title]
+        if title in active:
+            return 0, [title + ' (recursion)'], {'recursion'}
+        active.add(title)
+        problems = set()
+        if title == INDIRECT:
+            problems.add('indirect')
+            own = 0
+        elif title in graph.defined:
+            own, qualifier = graph.stack[title]
+            if 'dynamic' in qualifier:
+                problems.add('dynamic' if qualifier == 'dynamic' else 'bounded')
+        elif title.split(':')[-1] in assume:
+            own = assume[title.split(':')[-1]]
+        else:
+            own = 0
+            problems.add('unknown')
+        best, best_path = 0, []
+        for callee in sorted(graph.calls.get(title, ())):
+            depth, path, sub = visit(callee)
+            problems |= sub
+            if depth > best:
+                best, best_path = depth, path
+        active.discard(title)
+        memo[title] = (own + best, [title] + best_path, problems)
+        return memo[title]
+
+    return visit
+
+
+def name_list(path):
+    return ' > '.join(p.split(':')[-1] for p in path)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Worst-case stack depth report')
+    parser.add_argument('--root', default='main')
+    parser.add_argument('--isr', action='append', default=[])
+    parser.add_argument('--frame', type=int, default=36)
+    parser.add_argument('--call', action='append', default=[])
+    parser.add_argument('--assume', action='append', default=[])
+    parser.add_argument('--budget', type=int)
+    parser.add_argument('--top', type=int, default=25)
+    parser.add_argument('inputs', nargs='+')
+    args = parser.parse_args(argv[1:])
+
+    graph = CallGraph()
+    files = 0
+    for item in args.inputs:
+        paths = [item]
+        if os.path.isdir(item):
+            paths = [os.path.join(d, f) for d, _, names in os.walk(item)
+                     for f in names if f.endswith('.ci')]
+        for path in sorted(paths):
+            graph.load(path)
+            files += 1
+    if 0 == files:
+        sys.exit('No .ci files found; compile with -fcallgraph-info=su')
+
+    for spec in args.call:
+        caller, callee = spec.split('=', 1)
+        source = graph.resolve(caller) or caller
+        graph.calls.setdefault(source, set()).add(graph.resolve(callee) or callee)
+    assume = {}
+    for spec in args.assume:
+        name, size = spec.split('=', 1)
+        assume[name] = int(size)
+
+    visit = analyse(graph, assume)
+
+    print('Stack usage per function, deepest first (bytes)')
+    print('%6s %6s  %s' % ('Self', 'Worst', 'Function'))
+    rows = sorted(((visit(t)[0], graph.stack[t][0], t) for t in graph.defined), reverse=True)
+    for worst, own, title in rows[:args.top]:
+        print('%6d %6d  %s' % (own, worst, title))
+
+    roots = [(args.root, None)]
+    for spec in args.isr:
+        name, priority = spec.rsplit(':', 1)
+        roots.append((name, int(priority)))
+
+    print('\nRoots')
+    depth = {}
+    problems = set()
+    for name, priority in roots:
+        title = graph.resolve(name)
+        if title is None:
+            print('  %-28s not found' % name)
+            continue
+        worst, path, sub = visit(title)
+        problems |= sub
+        depth[name] = worst
+        print('  %-28s %6d  %s' % (name if priority is None else '%s (priority %d)' % (name, priority),
+                                    worst, name_list(path)))
+
+    # One handler per distinct priority can be active at a time, each
+    # preempted by the next more urgent level.
+    total = depth.get(args.root, 0)
+    terms = ['%s %d' % (args.root, total)]
+    levels = {}
+    for name, priority in roots[1:]:
+        if name in depth:
+            levels[priority] = max(levels.get(priority, 0), depth[name])
+    for priority in sorted(levels, reverse=True):
+        total += levels[priority] + args.frame
+        terms.append('priority %d %d + frame %d' % (priority, levels[priority], args.frame))
+    print('\nWorst case with interrupt nesting: %s = %d bytes' % (' + '.join(terms), total))
+
+    notes = {
+        'unknown': 'Calls to functions without call graph information count as 0 bytes',
+        'indirect': 'Unresolved indirect calls count as 0 bytes; add them with --call',
+        'dynamic': 'Some functions use unbounded dynamic stack (alloca or VLA)',
+        'bounded': 'Some functions use bounded dynamic stack; the bound is included',
+        'recursion': 'Recursion found; each cycle is counted once',
+    }
+    for key in sorted(problems):
+        print('Note: %s' % notes[key])
+    if 'unknown' in problems:
+        unknown = sorted({c.split(':')[-1] for callees in graph.calls.values() for c in callees
+                          if c not in graph.defined and c != INDIRECT and c.split(':')[-1] not in assume})
+        print('  Without information: %s' % ', '.join(unknown))
+    if 'indirect' in problems:
+        callers = sorted(t for t, callees in graph.calls.items() if INDIRECT in callees)
+        print('  Indirect calls in: %s' % ', '.join(callers))
+
+    if args.budget is not None and total > args.budget:
+        print('Stack budget of %d bytes exceeded' % args.budget)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,521 @@
+/*******************************************************************************
+* File Name: tank_sim.c
+*
+* Description: This file contains a synthetic tank model that generates sensor
+*              raw counts for host runs. It models the probe geometry, liquid
+*              dielectric, container wall, per-sensor gain spread, noise, temperature drift,
+*              slosh, tilt and droplets along a scripted level trajectory.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "tank_sim.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define PI_F                (3.14159265f)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Command line options mapped to tank_sim_config_t fields */
+static const struct
+{
+    const char *name;
+    uint8_t isFloat;
+    size_t offset;
+} options[] =
+{
+    {"--dielectric",  1u, offsetof(tank_sim_config_t, dielectric)},
+    {"--wall-mm",     1u, offsetof(tank_sim_config_t, wallMm)},
+    {"--wall-eps",    1u, offsetof(tank_sim_config_t, wallEps)},
+    {"--empty-raw",   1u, offsetof(tank_sim_config_t, emptyRaw)},
+    {"--wet-delta",   1u, offsetof(tank_sim_config_t, wetDelta)},
+    {"--gain-spread", 1u, offsetof(tank_sim_config_t, gainSpread)},
+    {"--noise",       1u, offsetof(tank_sim_config_t, noise)},
+    {"--common-noise", 1u, offsetof(tank_sim_config_t, commonNoise)},
+    {"--drift",       1u, offsetof(tank_sim_config_t, driftPerDegC)},
+    {"--temp",        1u, offsetof(tank_sim_config_t, tempAmplitude)},
+    {"--temp-period", 0u, offsetof(tank_sim_config_t, tempPeriodMs)},
+    {"--slosh",       1u, offsetof(tank_sim_config_t, sloshMm)},
+    {"--tilt-mm",     1u, offsetof(tank_sim_config_t, tiltMm)},
+    {"--slosh-hz",    1u, offsetof(tank_sim_config_t, sloshHz)},
+    {"--droplets",    1u, offsetof(tank_sim_config_t, dropletRate)},
+    {"--frame-ms",    0u, offsetof(tank_sim_config_t, frameMs)},
+    {"--seed",        0u, offsetof(tank_sim_config_t, seed)},
+};
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static float random_uniform(tank_sim_t *sim);
+static float random_gauss(tank_sim_t *sim);
+static float dielectric_response(float dielectric);
+static float wall_response(float depthMm, float wallMm, float wallEps);
+static float level_at(const tank_sim_t *sim, uint32_t timeMs);
+static float wet_fraction(float surface, float bottom, float top, float tiltMm);
+
+
+/*******************************************************************************
+* Function Name: tank_sim_default_config
+********************************************************************************
+* Summary:
+*  This function fills in a water tank on the 12 sensor shield with moderate
+*  noise and no drift, slosh or droplets.
+*
+*******************************************************************************/
+void tank_sim_default_config(tank_sim_config_t *config)
+{
+    config->numSensors = 12u;
+    config->probeMm = 153.0f;
+    config->frameMs = 100u;
+    config->dielectric = TANK_SIM_EPS_WATER;
+    config->wallMm = TANK_SIM_WALL_REF_MM;
+    config->wallEps = TANK_SIM_WALL_REF_EPS;
+    config->emptyRaw = 450.0f;
+    config->emptySpread = 20.0f;
+    config->wetDelta = 160.0f;
+    config->gainSpread = 0.05f;
+    config->noise = 3.0f;
+    config->commonNoise = 0.0f;
+    config->driftPerDegC = 0.5f;
+    config->tempAmplitude = 0.0f;
+    config->tempPeriodMs = 600000u;
+    config->sloshMm = 0.0f;
+    config->sloshHz = 1.0f;
+    config->tiltMm = 0.0f;
+    config->dropletRate = 0.0f;
+    config->dropletDecay = 0.9f;
+    config->seed = 1u;
+}
+
+/*******************************************************************************
+* Function Name: tank_sim_init
+********************************************************************************
+* Summary:
+*  This function initializes the simulator. The per-sensor dry counts and gains
+*  are drawn once from the seed. The end electrodes have half the area of the
+*  middle ones, which is what sensorScale[] corrects in the firmware. The
+*  gains include the coupling through the wall relative to the reference
+*  wall, which costs the smaller end electrodes more.
+*
+*******************************************************************************/
+void tank_sim_init(tank_sim_t *sim, const tank_sim_config_t *config)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->config = *config;
+    if(sim->config.numSensors > TANK_SIM_MAX_SENSORS)
+    {
+        sim->config.numSensors = TANK_SIM_MAX_SENSORS;
+    }
+    sim->rng = (0u != config->seed) ? config->seed : 1u;
+
+    for(uint8_t i = 0; i < sim->config.numSensors; i++)
+    {
+        float area = ((i == 0) || (i == sim->config.numSensors - 1)) ? 0.5f : 1.0f;
+        float bottom;
+        float top;
+        float depth;
+
+        tank_sim_sensor_span(sim, i, &bottom, &top);
+        depth = TANK_SIM_FIELD_DEPTH * (top - bottom);
+
+        sim->base[i] = config->emptyRaw + config->emptySpread * (2.0f * random_uniform(sim) - 1.0f);
+        sim->gain[i] = area * (1.0f + config->gainSpread * (2.0f * random_uniform(sim) - 1.0f)) *
+                       wall_response(depth, config->wallMm, config->wallEps) /
+                       wall_response(depth, TANK_SIM_WALL_REF_MM, TANK_SIM_WALL_REF_EPS);
+    }
+}
+
+/*******************************************************************************
+* Function Name: tank_sim_set_script
+********************************************************************************
+* Summary:
+*  This function sets the level trajectory from a string of "timeMs:levelMm"
+*  points separated by commas, e.g. "0:0,10000:153,20000:40". Times must
+*  increase. The level holds before the first and after the last point.
+*
+* Return:
+*  0 on success, -1 if the script is malformed.
+*
+*******************************************************************************/
+int tank_sim_set_script(tank_sim_t *sim, const char *script)
+{
+    const char *p = script;
+    char *end;
+
+    sim->numPoints = 0u;
+    while('\0' != *p)
+    {
+        tank_sim_point_t point;
+
+        if(sim->numPoints >= TANK_SIM_MAX_POINTS)
+        {
+            return -1;
+        }
+        point.timeMs = (uint32_t)strtoul(p, &end, 10);
+        if((end == p) || (':' != *end))
+        {
+            return -1;
+        }
+        p = end + 1;
+        point.levelMm = strtof(p, &end);
+        if(end == p)
+        {
+            return -1;
+        }
+        if((sim->numPoints > 0u) && (point.timeMs <= sim->points[sim->numPoints - 1u].timeMs))
+        {
+            return -1;
+        }
+        if((',' != *end) && ('\0' != *end))
+        {
+            return -1;
+        }
+        sim->points[sim->numPoints++] = point;
+        p = (',' == *end) ? end + 1 : end;
+    }
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: tank_sim_level_mm
+********************************************************************************
+* Summary:
+*  This function returns the true (slosh free) level of the next frame.
+*
+*******************************************************************************/
+float tank_sim_level_mm(const tank_sim_t *sim)
+{
+    return level_at(sim, sim->timeMs);
+}
+
+/*******************************************************************************
+* Function Name: tank_sim_sensor_span
+********************************************************************************
+* Summary:
+*  This function returns the bottom and top height of an electrode in mm. The
+*  end electrodes are half the height of the middle ones.
+*
+*******************************************************************************/
+void tank_sim_sensor_span(const tank_sim_t *sim, uint8_t sensor, float *bottom, float *top)
+{
+    float height = sim->config.probeMm / (float)(sim->config.numSensors - 1u);
+
+    *bottom = (0u == sensor) ? 0.0f : (height * ((float)sensor - 0.5f));
+    *top = (sensor == sim->config.numSensors - 1u) ? sim->config.probeMm : (height * ((float)sensor + 0.5f));
+}
+
+/*******************************************************************************
+* Function Name: tank_sim_baseline
+********************************************************************************
+* Summary:
+*  This function returns the noise free raw counts of the dry probe at the
+*  reference temperature, i.e. an ideal empty container calibration.
+*
+*******************************************************************************/
+void tank_sim_baseline(const tank_sim_t *sim, int32_t *raw, uint8_t count)
+{
+    for(uint8_t i = 0; i < count; i++)
+    {
+        raw[i] = (i < sim->config.numSensors) ? (int32_t)lrintf(sim->base[i]) : 0;
+    }
+}
+
+/*******************************************************************************
+* Function Name: tank_sim_next_frame
+********************************************************************************
+* Summary:
+*  This function produces the raw counts of the next frame and advances the
+*  simulated time by one frame period.
+*
+*******************************************************************************/
+void tank_sim_next_frame(tank_sim_t *sim, int32_t *raw, uint8_t count)
+{
+    const tank_sim_config_t *config = &sim->config;
+    float t = (float)sim->timeMs / 1000.0f;
+    float surface = level_at(sim, sim->timeMs);
+    float response = config->wetDelta * dielectric_response(config->dielectric);
+    float drift = 0.0f;
+
+    if(0.0f != config->sloshMm)
+    {
+        surface += config->sloshMm * sinf(2.0f * PI_F * config->sloshHz * t);
+    }
+    if((0.0f != config->tempAmplitude) && (0u != config->tempPeriodMs))
+    {
+        drift = config->driftPerDegC * config->tempAmplitude *
+                sinf(2.0f * PI_F * (float)sim->timeMs / (float)config->tempPeriodMs);
+    }
+    if(0.0f != config->commonNoise)
+    {
+        /* Grounding, a hand nearby or EMI shift all electrodes at once */
+        drift += config->commonNoise * random_gauss(sim);
+    }
+
+    for(uint8_t i = 0; i < count; i++)
+    {
+        float bottom;
+        float top;
+        float wet;
+        float value;
+
+        if(i >= config->numSensors)
+        {
+            raw[i] = 0;
+            continue;
+        }
+
+        tank_sim_sensor_span(sim, i, &bottom, &top);
+        wet = wet_fraction(surface, bottom, top, config->tiltMm);
+
+        /* Droplets land on the dry part of an electrode and run off slowly */
+        sim->droplet[i] *= config->dropletDecay;
+        if((wet < 1.0f) && (random_uniform(sim) < config->dropletRate))
+        {
+            sim->droplet[i] += 0.3f;
+        }
+        if(sim->droplet[i] > 1.0f - wet)
+        {
+            sim->droplet[i] = 1.0f - wet;
+        }
+
+        value = sim->base[i] + drift +
+                sim->gain[i] * response * (wet + sim->droplet[i]) +
+                config->noise * random_gauss(sim);
+        raw[i] = (value < 0.0f) ? 0 : (int32_t)lrintf(value);
+    }
+
+    sim->timeMs += config->frameMs;
+}
+
+/*******************************************************************************
+* Function Name: tank_sim_frame_source
+********************************************************************************
+* Summary:
+*  Adapter that lets hal_posix_set_frame_source() pull frames from a
+*  tank_sim_t passed as context.
+*
+*******************************************************************************/
+void tank_sim_frame_source(int32_t *raw, uint8_t count, void *context)
+{
+    tank_sim_next_frame((tank_sim_t *)context, raw, count);
+}
+
+/*******************************************************************************
+* Function Name: tank_sim_parse_option
+********************************************************************************
+* Summary:
+*  This function applies one "--name value" command line option to a
+*  configuration, so that all host tools accept the same model options.
+*
+* Return:
+*  1 if the option is a model option, 0 otherwise.
+*
+*******************************************************************************/
+int tank_sim_parse_option(tank_sim_config_t *config, const char *name, const char *value)
+{
+    for(uint8_t i = 0; i < sizeof(options) / sizeof(options[0]); i++)
+    {
+        if(0 == strcmp(name, options[i].name))
+        {
+            uint8_t *field = (uint8_t *)config + options[i].offset;
+
+            if(0u != options[i].isFloat)
+            {
+                *(float *)field = strtof(value, NULL);
+            }
+            else
+            {
+                *(uint32_t *)field = (uint32_t)strtoul(value, NULL, 0);
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: tank_sim_print_options
+*******************************************************************************/
+void tank_sim_print_options(FILE *stream)
+{
+    fprintf(stream,
+            "Tank model options:\n"
+            "  --dielectric EPS   Relative permittivity (water 80, coolant 40, oil 2.2)\n"
+            "  --wall-mm MM       Container wall thickness (default 2.0)\n"
+            "  --wall-eps EPS     Wall relative permittivity (default 3.0, glass 6, PE 2.3)\n"
+            "  --empty-raw N      Mean raw count of a dry electrode\n"
+            "  --wet-delta N      Raw count increase of a wet middle electrode in water\n"
+            "                     through the default wall\n"
+            "  --gain-spread F    Relative per-sensor gain spread (0.05 = +-5 %%)\n"
+            "  --noise N          Raw count noise standard deviation\n"
+            "  --common-noise N   Standard deviation of a per-frame offset shared by all electrodes\n"
+            "  --drift N          Raw counts per degree C\n"
+            "  --temp N           Peak temperature excursion in degree C\n"
+            "  --temp-period MS   Temperature cycle period\n"
+            "  --slosh MM         Surface oscillation amplitude\n"
+            "  --tilt-mm MM       Surface height difference across the electrode width\n"
+            "  --slosh-hz F       Surface oscillation frequency\n"
+            "  --droplets P       Droplet probability per dry electrode and frame\n"
+            "  --frame-ms MS      Simulated time between frames\n"
+            "  --seed N           Random seed\n");
+}
+
+/*******************************************************************************
+* Function Name: random_uniform
+********************************************************************************
+* Summary:
+*  xorshift32 generator returning a value in [0, 1).
+*
+*******************************************************************************/
+static float random_uniform(tank_sim_t *sim)
+{
+    sim->rng ^= sim->rng << 13;
+    sim->rng ^= sim->rng >> 17;
+    sim->rng ^= sim->rng << 5;
+    return (float)(sim->rng >> 8) / 16777216.0f;
+}
+
+/*******************************************************************************
+* Function Name: random_gauss
+********************************************************************************
+* Summary:
+*  Box-Muller transform returning a standard normal value.
+*
+*******************************************************************************/
+static float random_gauss(tank_sim_t *sim)
+{
+    float u1 = random_uniform(sim) + (1.0f / 16777216.0f);
+    float u2 = random_uniform(sim);
+
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * PI_F * u2);
+}
+
+/*******************************************************************************
+* Function Name: dielectric_response
+********************************************************************************
+* Summary:
+*  This function returns the wet response relative to water. The coupling
+*  through the wall follows (eps - 1) / (eps + 2), which saturates for polar
+*  liquids and drops steeply for oils.
+*
+*******************************************************************************/
+static float dielectric_response(float dielectric)
+{
+    float water = (TANK_SIM_EPS_WATER - 1.0f) / (TANK_SIM_EPS_WATER + 2.0f);
+
+    return ((dielectric - 1.0f) / (dielectric + 2.0f)) / water;
+}
+
+/*******************************************************************************
+* Function Name: wall_response
+********************************************************************************
+* Summary:
+*  This function returns the part of the field of an electrode that couples
+*  through the wall to the liquid. The wall is a capacitance in series with
+*  the liquid, eps / t per area, against the fringe field of the electrode
+*  that reaches about its field depth: eps * d / (eps * d + t).
+*
+*******************************************************************************/
+static float wall_response(float depthMm, float wallMm, float wallEps)
+{
+    return (wallEps * depthMm) / ((wallEps * depthMm) + wallMm);
+}
+
+/*******************************************************************************
+* Function Name: wet_fraction
+********************************************************************************
+* Summary:
+*  This function returns the submerged part of an electrode area. A tilted
+*  surface rises linearly across the electrode width by tiltMm, centred on
+*  the level, and is sampled at TANK_SIM_TILT_POINTS points.
+*
+*******************************************************************************/
+static float wet_fraction(float surface, float bottom, float top, float tiltMm)
+{
+    float sum = 0.0f;
+    uint8_t points = (0.0f != tiltMm) ? TANK_SIM_TILT_POINTS : 1u;
+
+    for(uint8_t n = 0; n < points; n++)
+    {
+        float x = (((float)n + 0.5f) / (float)points) - 0.5f;
+        float wet = (surface + (tiltMm * x) - bottom) / (top - bottom);
+
+        sum += (wet < 0.0f) ? 0.0f : ((wet > 1.0f) ? 1.0f : wet);
+    }
+    return sum / (float)points;
+}
+
+/*******************************************************************************
+* Function Name: level_at
+********************************************************************************
+* Summary:
+*  This function interpolates the level trajectory at the given time.
+*
+*******************************************************************************/
+static float level_at(const tank_sim_t *sim, uint32_t timeMs)
+{
+    const tank_sim_point_t *points = sim->points;
+    uint8_t n = sim->numPoints;
+
+    if(0u == n)
+    {
+        return 0.0f;
+    }
+    if(timeMs <= points[0].timeMs)
+    {
+        return points[0].levelMm;
+    }
+    for(uint8_t i = 1; i < n; i++)
+    {
+        if(timeMs <= points[i].timeMs)
+        {
+            float f = (float)(timeMs - points[i - 1u].timeMs) /
+                      (float)(points[i].timeMs - points[i - 1u].timeMs);
+            return points[i - 1u].levelMm + f * (points[i].levelMm - points[i - 1u].levelMm);
+        }
+    }
+    return points[n - 1u].levelMm;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,140 @@
+/*******************************************************************************
+* File Name: tank_sim.h
+*
+* Description: This file is the public interface of tank_sim.c source file.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef HOST_TANK_SIM_H_
+#define HOST_TANK_SIM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define TANK_SIM_MAX_SENSORS        (32u)
+#define TANK_SIM_MAX_POINTS         (128u)
+
+/* Relative permittivity of common liquids */
+#define TANK_SIM_EPS_WATER          (80.0f)
+#define TANK_SIM_EPS_COOLANT        (40.0f)
+#define TANK_SIM_EPS_OIL            (2.2f)
+
+/* Container wall that wetDelta refers to, the one the default scales are
+ * tuned for
+ */
+#define TANK_SIM_WALL_REF_MM        (2.0f)
+#define TANK_SIM_WALL_REF_EPS       (3.0f)
+
+/* Depth that the field of an electrode reaches behind the probe, relative to
+ * the electrode height
+ */
+#define TANK_SIM_FIELD_DEPTH        (0.216f)
+
+/* Points across the electrode width that a tilted surface is sampled at */
+#define TANK_SIM_TILT_POINTS        (32u)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Tank and probe model parameters */
+typedef struct
+{
+    uint8_t numSensors;         /* Electrodes on the probe, bottom first */
+    float probeMm;              /* Probe length. End electrodes are half height */
+    uint32_t frameMs;           /* Simulated time between two frames */
+    float dielectric;           /* Relative permittivity of the liquid */
+    float wallMm;               /* Container wall thickness */
+    float wallEps;              /* Relative permittivity of the wall */
+    float emptyRaw;             /* Mean raw count of a dry electrode */
+    float emptySpread;          /* Peak deviation of the dry raw counts */
+    float wetDelta;             /* Raw count increase of a wet middle electrode in water */
+    float gainSpread;           /* Relative per-sensor gain spread, 0.05 = +-5 % */
+    float noise;                /* Standard deviation of the raw count noise */
+    float commonNoise;          /* Standard deviation of a per-frame offset shared by all electrodes */
+    float driftPerDegC;         /* Raw count change per degree C */
+    float tempAmplitude;        /* Peak temperature excursion in degree C */
+    uint32_t tempPeriodMs;      /* Period of the temperature cycle */
+    float sloshMm;              /* Surface oscillation amplitude */
+    float sloshHz;              /* Surface oscillation frequency */
+    float tiltMm;               /* Surface height difference across the electrode width */
+    float dropletRate;          /* Probability per frame of a droplet on a dry electrode */
+    float dropletDecay;         /* Fraction of a droplet response left after one frame */
+    uint32_t seed;              /* Seed of the noise and droplet generator */
+} tank_sim_config_t;
+
+/* Point of the scripted level trajectory. Levels are linearly interpolated. */
+typedef struct
+{
+    uint32_t timeMs;
+    float levelMm;
+} tank_sim_point_t;
+
+/* Simulator state */
+typedef struct
+{
+    tank_sim_config_t config;
+    tank_sim_point_t points[TANK_SIM_MAX_POINTS];
+    uint8_t numPoints;
+    uint32_t timeMs;
+    uint32_t rng;
+    float base[TANK_SIM_MAX_SENSORS];
+    float gain[TANK_SIM_MAX_SENSORS];
+    float droplet[TANK_SIM_MAX_SENSORS];
+} tank_sim_t;
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void tank_sim_default_config(tank_sim_config_t *config);
+void tank_sim_init(tank_sim_t *sim, const tank_sim_config_t *config);
+int tank_sim_set_script(tank_sim_t *sim, const char *script);
+float tank_sim_level_mm(const tank_sim_t *sim);
+void tank_sim_sensor_span(const tank_sim_t *sim, uint8_t sensor, float *bottom, float *top);
+void tank_sim_baseline(const tank_sim_t *sim, int32_t *raw, uint8_t count);
+void tank_sim_next_frame(tank_sim_t *sim, int32_t *raw, uint8_t count);
+void tank_sim_frame_source(int32_t *raw, uint8_t count, void *context);
+int tank_sim_parse_option(tank_sim_config_t *config, const char *name, const char *value);
+void tank_sim_print_options(FILE *stream);
+
+#endif /* HOST_TANK_SIM_H_ */
+
+
+/* [] END OF FILE  */
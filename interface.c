@@ -38,13 +38,33 @@
 * of such system or application assumes all risk of such use and in doing
 * so agrees to indemnify Cypress against all liability.
 *******************************************************************************/
-#include "cy_pdl.h"
-#include "cybsp.h"
-#include "cycfg.h"
+#include "hal.h"
 #include "interface.h"
-#include "cy_em_eeprom.h"
+#include "sweep.h"
+#include "history.h"
+#include "datalog.h"
+#include "alarm.h"
+#include "stats.h"
+#include "liquid.h"
+#include "wall.h"
+#include "tilt.h"
+#include "edge.h"
 
 #include<stdio.h>
+#include<string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Seed of the sample table checksum, so that erased storage is rejected */
+#define SAMPLE_TABLE_CHECK  (0x5A5Au)
+/* Longest basic output line plus terminator */
+#define LEVEL_LINE_SIZE     (64u)
+
+/* The calibration values, the sample table, the alarm, liquid and wall
+ * configuration must fit the smallest storage
+ */
+typedef char storage_layout_check_t[((WALL_CONFIG_START + WALL_CONFIG_SIZE) <= HAL_STORAGE_SIZE) ? 1 : -1];
 
 /*******************************************************************************
 * Global Variables
@@ -53,7 +73,29 @@
 uint8_t uartTxMode = UART_BASIC;
 uint8_t storeSampleFlag = FALSE;
 uint8_t resetSampleFlag = FALSE;
-int16_t arrayAxisLabel[NUM_SAMPLES] = {-5,0,10,20,30,40,50,60,70,80,90,100,110,120,130,140,150,153,160,0};
+/* Flag to signal when new sensor calibration values should be stored to EEPROM */
+uint8_t cal_flag = FALSE;
+/* Flag to signal that the sensor self-test should run before the next scan */
+uint8_t selftestFlag = FALSE;
+/* Flag to signal that the surface should be acquired before the next scan */
+uint8_t acquireFlag = FALSE;
+/* Command line being received */
+static uint16_t bufferIndex = 0;
+static char rxBuffer[UART_RX_BUFFER_SIZE]= {'\0'};
+
+/* Sample table used until one is stored, for the CY8CKIT-022 probe */
+static const int16_t defaultAxisLabel[] = {-5,0,10,20,30,40,50,60,70,80,90,100,110,120,130,140,150,153,160};
+/* Active sample table */
+int16_t arrayAxisLabel[SAMPLE_TABLE_MAX];
+uint8_t numSamples = 0;
+
+/* Last basic output line and the values it shows. In lazy mode the line is
+ * only formatted again when one of them changes.
+ */
+static char levelLine[LEVEL_LINE_SIZE];
+static int32_t levelLineMm = -1;
+static int32_t levelLinePercent = -1;
+static int32_t levelLineSpread = -1;
 
 /*******************************************************************************
 * Function Name: display_uart_commands
@@ -71,15 +113,39 @@ int16_t arrayAxisLabel[NUM_SAMPLES] = {-5,0,10,20,30,40,50,60,70,80,90,100,110,1
 /* Transmit list of available commands */
 void display_uart_commands(void)
 {
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "\n\r");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "Commands \n\r");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "  stop - Stops dislaying data over UART.\n\r");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "  cal - Stores empty container sensor values to EEPROM for calibration.\n\r");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "  basic - Outputs liquid level in mm and %.\n\r");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "  csv - Outputs intermediate computation values as well as liquid level in CSV format.\n\r");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "  'Enter' - Outputs the next set of level values from the sample array.\n\r");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "  reset - Resets the sample array pointer to 0 %.\n\r");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "\n\r");
+    hal_uart_put_string("\n\r");
+    hal_uart_put_string("Commands \n\r");
+    hal_uart_put_string("  stop - Stops dislaying data over UART.\n\r");
+    hal_uart_put_string("  cal - Stores empty container sensor values to EEPROM for calibration.\n\r");
+    hal_uart_put_string("  basic - Outputs liquid level in mm and %.\n\r");
+    hal_uart_put_string("  csv - Outputs intermediate computation values as well as liquid level in CSV format.\n\r");
+    hal_uart_put_string("  'Enter' - Outputs the next set of level values from the sample array.\n\r");
+    hal_uart_put_string("  reset - Resets the sample array pointer to 0 %, or aborts a sweep.\n\r");
+    hal_uart_put_string("  table - Shows the sample array. 'table new', 'table add MM[,MM..]', 'table save'\n\r");
+    hal_uart_put_string("          and 'table default' edit it.\n\r");
+    hal_uart_put_string("  hist [S] - Shows level statistics of the RAM history, or of its last S seconds.\n\r");
+    hal_uart_put_string("  hist dump - Stops the output and downloads the RAM history in binary.\n\r");
+    hal_uart_put_string("  hist clear - Clears the RAM history.\n\r");
+    hal_uart_put_string("  log - Shows the state of the flash log. 'log flush' writes the pending records.\n\r");
+    hal_uart_put_string("  log dump [FROM [TO]] - Stops the output and downloads the flash log in binary.\n\r");
+    hal_uart_put_string("  sweep [N] - Characterization sweep over the sample array, averaging N frames per point.\n\r");
+    hal_uart_put_string("  alarm - Shows the alarms. 'alarm hh|h|l|ll SENSOR|off', 'alarm hyst N' and\n\r");
+    hal_uart_put_string("          'alarm save' edit them.\n\r");
+    hal_uart_put_string("  selftest - Runs the sensor self-test: pin shorts and electrode capacitance.\n\r");
+    hal_uart_put_string("  acquire - Finds the level with single sensor scans in bisection order, as at power-on.\n\r");
+    hal_uart_put_string("  liquid - Shows the liquid class. 'liquid auto' detects it when the probe is full,\n\r");
+    hal_uart_put_string("          'liquid NAME' sets it.\n\r");
+    hal_uart_put_string("  wall [MM EPS] - Shows the wall compensation, or sets the wall thickness in mm and\n\r");
+    hal_uart_put_string("          its permittivity, e.g. 'wall 6 2.6'.\n\r");
+    hal_uart_put_string("  tilt - Shows the tilt-aware level. 'tilt on' reports it as the level, 'tilt off' the\n\r");
+    hal_uart_put_string("          submerged sensor count.\n\r");
+    hal_uart_put_string("  edge - Shows the level at the largest rise between adjacent sensors. 'edge on' reports\n\r");
+    hal_uart_put_string("          it as the level, 'edge off' the sensors above the threshold.\n\r");
+    hal_uart_put_string("  lazy - Shows the lazy mode counters. 'lazy on' skips the sensors and output that have not\n\r");
+    hal_uart_put_string("          changed, 'lazy band N' sets the raw count change that counts, 'lazy off'.\n\r");
+    hal_uart_put_string("  stats - Shows noise statistics per sensor. 'stats window N' sets the frames per window,\n\r");
+    hal_uart_put_string("          'stats wet' takes the means of the last window as the wet response.\n\r");
+    hal_uart_put_string("\n\r");
 }
 
 /*******************************************************************************
@@ -98,68 +164,119 @@ void display_current_cal_val(void)
 {
     uint8_t i;
 
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "EmptyCal=");
+    hal_uart_put_string("EmptyCal=");
     for(i = 0; i < NUMSENSORS; i++)
     {
         display_decimal_val(sensorEmptyOffset[i], 0);
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+        hal_uart_put_string(",");
     }
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n");
+    hal_uart_put_string("\r\n");
 }
 
 /*******************************************************************************
-* Function Name: display_decimal_val
+* Function Name: format_unsigned_val
 ********************************************************************************
 * Summary:
-* This function displays the decimal representation of a int32 variable with
-* optional leading zeros in the UART terminal.
+* This function writes the decimal representation of an unsigned magnitude
+* with optional leading zeros to a buffer of at least 11 characters, and
+* terminates it.
 *
 * Parameters:
-*    number           Number to be displayed in decimal format.
+*    text             Buffer written.
+*    magnitude        Number to be written in decimal format.
 *    leading_zeros    Number of leading zeros to force display of.
-*                     Useful for fractional numbers after decimal point.
 *
 * Return:
-*  void
+*  Number of digits written.
 *******************************************************************************/
-void display_decimal_val(int32_t number, int8_t leading_zeros)
+static uint8_t format_unsigned_val(char *text, uint32_t magnitude, int8_t leading_zeros)
 {
     uint8_t digit = 0;
     uint8_t zero_flag = 0;
+    uint8_t length = 0;
     int8_t i = 0;
 
-    const int32_t decimal[] = {1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1};
+    const uint32_t decimal[] = {1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1};
 
     /* Check for out of range parameters */
     if(leading_zeros > 10)
     {
         leading_zeros = 10;
     }
-    if(number < 0)
-    {
-        number *= -1;
-        Cy_SCB_UART_Put(CYBSP_UART_HW, '-');
-    }
 
     /* Loop through each digit and subtract out represented decimal quantity */
     for(i = 0; i <= 9; i++)
     {
         digit = 0;
-        while(number >= decimal[i])
+        while(magnitude >= decimal[i])
         {
             zero_flag = 1;
-            number -= decimal[i];
+            magnitude -= decimal[i];
             digit++;
         }
-        /* display digit (and any following) if digit > 0, 1s digit = 0, or
+        /* write digit (and any following) if digit > 0, 1s digit = 0, or
          *  we have reached the number of forced leading zeros.
          */
         if((zero_flag == 1) || (i == 9) || (i >= (10 - leading_zeros)))
         {
-            while (!Cy_SCB_UART_Put(CYBSP_UART_HW, digit + 48));
+            text[length++] = (char)(digit + 48);
         }
     }
+    text[length] = '\0';
+    return length;
+}
 
+/*******************************************************************************
+* Function Name: display_unsigned_val
+********************************************************************************
+* Summary:
+* This function displays the decimal representation of an unsigned magnitude
+* with optional leading zeros in the UART terminal.
+*
+* Parameters:
+*    magnitude        Number to be displayed in decimal format.
+*    leading_zeros    Number of leading zeros to force display of.
+*
+* Return:
+*  void
+*******************************************************************************/
+static void display_unsigned_val(uint32_t magnitude, int8_t leading_zeros)
+{
+    char digits[11];
+    uint8_t length = format_unsigned_val(digits, magnitude, leading_zeros);
+
+    for(uint8_t i = 0; i < length; i++)
+    {
+        while (!hal_uart_put((uint32_t)digits[i]));
+    }
+}
+
+/*******************************************************************************
+* Function Name: display_decimal_val
+********************************************************************************
+* Summary:
+* This function displays the decimal representation of a int32 variable with
+* optional leading zeros in the UART terminal.
+*
+* Parameters:
+*    number           Number to be displayed in decimal format.
+*    leading_zeros    Number of leading zeros to force display of.
+*                     Useful for fractional numbers after decimal point.
+*
+* Return:
+*  void
+*******************************************************************************/
+void display_decimal_val(int32_t number, int8_t leading_zeros)
+{
+    /* Unsigned magnitude so that INT32_MIN can be negated */
+    uint32_t magnitude = (uint32_t)number;
+
+    if(number < 0)
+    {
+        magnitude = 0u - magnitude;
+        hal_uart_put('-');
+    }
+    display_unsigned_val(magnitude, leading_zeros);
 }
 
 /*******************************************************************************
@@ -179,24 +296,169 @@ void display_decimal_val(int32_t number, int8_t leading_zeros)
 void store_calibration(void)
 {
     uint8_t i;
-    cy_en_em_eeprom_status_t em_eeprom_status;
+    uint32_t storage_status;
+    int32_t record[NUMSENSORS];
 
     /* Calculate offset for each sensor */
     for(i = 0; i < NUMSENSORS; i++)
     {
-          sensorEmptyOffset[i] = sensorDiff[i];
+          sensorEmptyOffset[i] = level_sensor_raw(i);
+          record[i] = sensorEmptyOffset[i];
     }
+    level_update_thresholds();
     display_current_cal_val();
 
     /* Store new cal values */
-    /* Write initial data to Emulated EEPROM. */
-    em_eeprom_status = Cy_Em_EEPROM_Write(LOGICAL_EM_EEPROM_START,
-                                             sensorEmptyOffset,
-                                             LOGICAL_EM_EEPROM_SIZE,
-                                             &em_eeprom_context);
+    /* Write initial data to Emulated EEPROM. The stored record keeps its
+     * original 32-bit layout so existing calibrations stay valid.
+     */
+    storage_status = hal_storage_write(LOGICAL_EM_EEPROM_START,
+                                       record,
+                                       LOGICAL_EM_EEPROM_SIZE);
 
     /* EEPROM Error handler */
-    handle_error(em_eeprom_status, "Emulated EEPROM Write failed \r\n");
+    handle_error(storage_status, "Emulated EEPROM Write failed \r\n");
+}
+
+/*******************************************************************************
+* Function Name: load_calibration
+********************************************************************************
+* Summary:
+* This function reads the stored empty offset values from emulated EEPROM.
+* Values outside the raw count range are clamped.
+*
+* Parameters:
+*    void
+*
+* Return:
+*  void
+*******************************************************************************/
+void load_calibration(void)
+{
+    uint8_t i;
+    uint32_t storage_status;
+    int32_t record[NUMSENSORS];
+
+    storage_status = hal_storage_read(LOGICAL_EM_EEPROM_START, record,
+                                      LOGICAL_EM_EEPROM_SIZE);
+    handle_error(storage_status, "Emulated EEPROM Read failed \r\n");
+
+    for(i = 0; i < NUMSENSORS; i++)
+    {
+        if(record[i] < 0)
+        {
+            record[i] = 0;
+        }
+        else if(record[i] > UINT16_MAX)
+        {
+            record[i] = UINT16_MAX;
+        }
+        sensorEmptyOffset[i] = (uint16_t)record[i];
+    }
+    level_update_thresholds();
+}
+
+/*******************************************************************************
+* Function Name: sample_table_check
+********************************************************************************
+* Summary:
+* This function computes the checksum of a sample table.
+*
+*******************************************************************************/
+static uint16_t sample_table_check(const sample_table_t *table)
+{
+    uint16_t check = (uint16_t)(SAMPLE_TABLE_CHECK + table->count);
+
+    for(uint8_t i = 0; (i < table->count) && (i < SAMPLE_TABLE_MAX); i++)
+    {
+        check = (uint16_t)(check + (uint16_t)table->labelMm[i]);
+    }
+    return check;
+}
+
+/*******************************************************************************
+* Function Name: load_sample_table
+********************************************************************************
+* Summary:
+* This function reads the sample table from emulated EEPROM. The default table
+* is used if none has been stored or the stored one is not valid.
+*
+* Parameters:
+*    void
+*
+* Return:
+*  void
+*******************************************************************************/
+void load_sample_table(void)
+{
+    sample_table_t table;
+    uint32_t storage_status;
+
+    storage_status = hal_storage_read(SAMPLE_TABLE_START, &table, SAMPLE_TABLE_SIZE);
+    handle_error(storage_status, "Emulated EEPROM Read failed \r\n");
+
+    if((table.count > 0u) && (table.count <= SAMPLE_TABLE_MAX) &&
+       (table.check == sample_table_check(&table)))
+    {
+        memcpy(arrayAxisLabel, table.labelMm, table.count * sizeof(int16_t));
+        numSamples = (uint8_t)table.count;
+    }
+    else
+    {
+        memcpy(arrayAxisLabel, defaultAxisLabel, sizeof(defaultAxisLabel));
+        numSamples = sizeof(defaultAxisLabel) / sizeof(defaultAxisLabel[0]);
+    }
+}
+
+/*******************************************************************************
+* Function Name: store_sample_table
+********************************************************************************
+* Summary:
+* This function stores the active sample table to emulated EEPROM.
+*
+* Parameters:
+*    void
+*
+* Return:
+*  void
+*******************************************************************************/
+void store_sample_table(void)
+{
+    sample_table_t table;
+    uint32_t storage_status;
+
+    memset(&table, 0, sizeof(table));
+    table.count = numSamples;
+    memcpy(table.labelMm, arrayAxisLabel, numSamples * sizeof(int16_t));
+    table.check = sample_table_check(&table);
+
+    storage_status = hal_storage_write(SAMPLE_TABLE_START, &table, SAMPLE_TABLE_SIZE);
+    handle_error(storage_status, "Emulated EEPROM Write failed \r\n");
+}
+
+/*******************************************************************************
+* Function Name: display_sample_table
+********************************************************************************
+* Summary:
+* This function displays the active sample table in the UART terminal.
+*
+* Parameters:
+*    void
+*
+* Return:
+*  void
+*******************************************************************************/
+void display_sample_table(void)
+{
+    uint8_t i;
+
+    hal_uart_put_string("Table=");
+    for(i = 0; i < numSamples; i++)
+    {
+        display_decimal_val(arrayAxisLabel[i], 0);
+        hal_uart_put_string(",");
+    }
+    hal_uart_put_string("\r\n");
 }
 
 /********************************************************************************
@@ -217,18 +479,71 @@ void store_calibration(void)
 ********************************************************************************/
 void handle_error(uint32_t status, char *message)
 {
-    if(CY_EM_EEPROM_SUCCESS != status)
+    if(HAL_SUCCESS != status)
     {
-        __disable_irq();
         if(NULL != message)
         {
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, message);
+            hal_uart_put_string(message);
         }
-        while(1u);
+        hal_halt();
     }
 
 }
 
+/*******************************************************************************
+* Function Name: format_tenths
+********************************************************************************
+* Summary:
+* This function writes a non-negative fixed precision 24.8 value with one
+* decimal digit, truncated, to a buffer of at least 13 characters.
+*
+* Return:
+*  Number of characters written.
+*******************************************************************************/
+static uint8_t format_tenths(char *text, int32_t value)
+{
+    uint8_t length = format_unsigned_val(text, (uint32_t)value >> 8, 0);
+
+    text[length++] = '.';
+    return length + format_unsigned_val(&text[length], (((uint32_t)value & 0x000000FFu) * 10u) >> 8, 0);
+}
+
+/*******************************************************************************
+* Function Name: format_level_line
+********************************************************************************
+* Summary:
+* This function formats the basic output line of the current level into
+* levelLine[] and records the values it shows.
+*
+* Parameters:
+*    spread    Spread of the tilt-aware level, or -1 if tilt is off.
+*
+*******************************************************************************/
+static void format_level_line(int32_t spread)
+{
+    char *text = levelLine;
+
+    levelLineMm = levelMm;
+    levelLinePercent = levelPercent;
+    levelLineSpread = spread;
+
+    /* Current liquid level percent and mm, with one decimal digit */
+    strcpy(text, "%=");
+    text += 2;
+    text += format_tenths(text, levelPercent);
+    strcpy(text, "   mm=");
+    text += 6;
+    text += format_tenths(text, levelMm);
+    if(spread >= 0)
+    {
+        /* The level is the tilt-aware estimate, add its spread */
+        strcpy(text, "   spread=");
+        text += 10;
+        text += format_tenths(text, spread);
+    }
+    strcpy(text, "\r\n");
+}
+
 /*******************************************************************************
 * Function Name: display_cur_liquid_level
 ********************************************************************************
@@ -248,72 +563,70 @@ void display_cur_liquid_level(void)
     
     if(uartTxMode == UART_BASIC)
     {
-        /* Transmit current liquid level Percent */
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, "%=");
-        display_decimal_val(levelPercent >> 8, 0);
-        /* Add one decimal point digit to percent */
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, ".");
-        display_decimal_val(((levelPercent & 0x000000FF) * 10) >> 8, 0);
-        /* Transmit current liquid level mm */
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, "   mm=");
-        display_decimal_val(levelMm >> 8, 0);
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, ".");
-        display_decimal_val(((levelMm & 0x000000FF) * 10) >> 8, 0);
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n");
+        int32_t spread = (tiltEnable == TRUE) ? tiltSpreadMm : -1;
+
+        /* In lazy mode, an unchanged level is sent without formatting it again */
+        if((levelLazy == FALSE) || (levelMm != levelLineMm) ||
+           (levelPercent != levelLinePercent) || (spread != levelLineSpread))
+        {
+            format_level_line(spread);
+        }
+        hal_uart_put_string(levelLine);
     }
     if(uartTxMode == UART_CSVINIT)
     {
         for(i = 0; i < NUMSENSORS; i++)
         {
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, "Raw");
+            hal_uart_put_string("Raw");
             display_decimal_val(i, 0);
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+            hal_uart_put_string(",");
         }
         for(i = 0; i < NUMSENSORS; i++)
         {
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, "Diff");
+            hal_uart_put_string("Diff");
             display_decimal_val(i, 0);
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+            hal_uart_put_string(",");
         }
         for(i = 0; i < NUMSENSORS; i++)
         {
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, "Proc");
+            hal_uart_put_string("Proc");
             display_decimal_val(i, 0);
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+            hal_uart_put_string(",");
         }
 
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, "SenActCnt,");
+        hal_uart_put_string("SenActCnt,");
 
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, "Level%, LevelMm");
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n");
+        hal_uart_put_string("Level%, LevelMm");
+        hal_uart_put_string("\r\n");
         uartTxMode = UART_CSV;
     }
     else if(uartTxMode == UART_CSV)
     {
         for(i = 0; i < NUMSENSORS; i++)
         {
-            display_decimal_val(sensorRaw[i], 0);
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+            display_decimal_val(level_sensor_raw(i), 0);
+            hal_uart_put_string(",");
         }
         for(i = 0; i < NUMSENSORS; i++)
         {
-            display_decimal_val(sensorDiff[i], 0);
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+            display_decimal_val(level_sensor_diff(i), 0);
+            hal_uart_put_string(",");
         }
+        level_require_processed();
         for(i = 0; i < NUMSENSORS; i++)
         {
             display_decimal_val(sensorProcessed[i], 0);
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+            hal_uart_put_string(",");
         }
 
         display_decimal_val(sensorActiveCount, 0);
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+        hal_uart_put_string(",");
 
         display_decimal_fixed_val(levelPercent, 8, 1);
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+        hal_uart_put_string(",");
         /* Transmit current liquid level mm */
         display_decimal_fixed_val(levelMm, 8, 1);
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n");
+        hal_uart_put_string("\r\n");
     }
     
     /* Looking for UART commands. */
@@ -336,64 +649,584 @@ void display_cur_liquid_level(void)
 *******************************************************************************/
 void receive_uart_cmd(void)
 {
-    static uint16_t bufferIndex = 0;
-    static char rxBuffer[32]= {'\0'};
-    uint32_t read_data = 0;
-
     /* Check if there is a received character from user console */
-    if (0UL != Cy_SCB_UART_GetNumInRxFifo(CYBSP_UART_HW))
+    if (0UL != hal_uart_get_num_in_rx())
     {
-        /* Re-transmit whatever the user types on the console */
-        read_data = Cy_SCB_UART_Get(CYBSP_UART_HW);
+        assemble_uart_cmd(hal_uart_get());
+    }
+}
 
-        if(read_data > '0')
+/*******************************************************************************
+* Function Name: assemble_uart_cmd
+********************************************************************************
+* Summary:
+* This function echoes a received character and appends it to the command line.
+* A carriage return or line feed completes the line and passes it to
+* dispatch_uart_cmd().
+*
+* Parameters:
+*    read_data    Character received from the UART.
+*
+* Return:
+*  void
+*******************************************************************************/
+void assemble_uart_cmd(uint32_t read_data)
+{
+    /* Re-transmit whatever the user types on the console. Any printable
+     * character is kept so that commands can take numeric arguments.
+     */
+    if((read_data >= ' ') && (read_data <= '~'))
+    {
+        while (0UL == hal_uart_put(read_data))
         {
-            while (0UL == Cy_SCB_UART_Put(CYBSP_UART_HW, read_data))
-            {
 
-            }
+        }
+        /* Drop characters that do not fit. No command is that long, so an
+         * overlong line is reported as a command error.
+         */
+        if(bufferIndex < sizeof(rxBuffer) - 1u)
+        {
             rxBuffer[bufferIndex] = read_data;
             bufferIndex++;
         }
-        if((read_data == '\r') || (read_data == '\n'))
+    }
+    if((read_data == '\r') || (read_data == '\n'))
+    {
+        rxBuffer[bufferIndex] = '\0';
+        dispatch_uart_cmd(rxBuffer);
+
+        bufferIndex = 0;
+        memset(rxBuffer, '\0', strlen(rxBuffer));
+    }
+}
+
+/*******************************************************************************
+* Function Name: parse_uint
+********************************************************************************
+* Summary:
+* This function converts a command argument of decimal digits.
+*
+* Parameters:
+*    text     Argument, followed by a space or the end of the line.
+*    value    Receives the number.
+*
+* Return:
+*  Pointer past the digits, or NULL if the argument is not 1 to 9 digits.
+*******************************************************************************/
+static const char *parse_uint(const char *text, uint32_t *value)
+{
+    uint8_t digits = 0;
+
+    *value = 0u;
+    while((*text >= '0') && (*text <= '9') && (digits < 9u))
+    {
+        *value = (*value * 10u) + (uint32_t)(*text - '0');
+        text++;
+        digits++;
+    }
+    return ((digits > 0u) && ((*text == '\0') || (*text == ' '))) ? text : NULL;
+}
+
+/*******************************************************************************
+* Function Name: parse_tenths
+********************************************************************************
+* Summary:
+* This function converts a command argument of decimal digits with at most
+* one decimal, e.g. "6" or "2.6", to tenths.
+*
+* Parameters:
+*    text     Argument, followed by a space or the end of the line.
+*    value    Receives the number in tenths.
+*
+* Return:
+*  Pointer past the argument, or NULL if it is not 1 to 4 digits with an
+*  optional decimal.
+*******************************************************************************/
+static const char *parse_tenths(const char *text, uint32_t *value)
+{
+    uint8_t digits = 0;
+
+    *value = 0u;
+    while((*text >= '0') && (*text <= '9') && (digits < 4u))
+    {
+        *value = (*value * 10u) + (uint32_t)(*text - '0');
+        text++;
+        digits++;
+    }
+    *value *= 10u;
+    if((digits > 0u) && (*text == '.') && (text[1] >= '0') && (text[1] <= '9'))
+    {
+        *value += (uint32_t)(text[1] - '0');
+        text += 2;
+    }
+    return ((digits > 0u) && ((*text == '\0') || (*text == ' '))) ? text : NULL;
+}
+
+/*******************************************************************************
+* Function Name: parse_uint_arg
+********************************************************************************
+* Summary:
+* This function converts the only argument of a command.
+*
+* Return:
+*  TRUE if the argument is 1 to 9 digits and nothing else, FALSE otherwise.
+*******************************************************************************/
+static uint8_t parse_uint_arg(const char *text, uint32_t *value)
+{
+    text = parse_uint(text, value);
+
+    return ((text != NULL) && (*text == '\0')) ? TRUE : FALSE;
+}
+
+/*******************************************************************************
+* Function Name: add_table_points
+********************************************************************************
+* Summary:
+* This function appends a comma separated list of presets in mm to the sample
+* table. Nothing is added unless the whole list is valid and the table stays
+* in increasing order.
+*
+* Parameters:
+*    text    Null terminated list, e.g. "-5,0,10".
+*
+* Return:
+*  TRUE if the points were added, FALSE otherwise.
+*******************************************************************************/
+static uint8_t add_table_points(const char *text)
+{
+    int16_t points[SAMPLE_TABLE_MAX];
+    uint8_t count = 0;
+    int32_t value;
+    int32_t last = (numSamples > 0u) ? arrayAxisLabel[numSamples - 1u] : INT16_MIN;
+    uint8_t negative;
+    uint8_t digits;
+
+    do
+    {
+        negative = (*text == '-') ? TRUE : FALSE;
+        if(negative == TRUE)
         {
-            rxBuffer[bufferIndex] = '\0';
-            if(strcmp("cal", rxBuffer) == 0)
-            {
-                cal_flag = TRUE;
-            }
-            else if(strcmp("stop", rxBuffer) == 0)
-            {
-                uartTxMode = UART_NONE;
-            }
-            else if(strcmp("csv", rxBuffer) == 0)
-            {
-                uartTxMode = UART_CSVINIT;
-            }
-            else if(strcmp("basic", rxBuffer) == 0)
-            {
-                uartTxMode = UART_BASIC;
-            }
-            else if(strcmp("", rxBuffer) == 0)
-            {
-                storeSampleFlag = TRUE;
-                uartTxMode = UART_NONE;
-            }
-            else if((strcmp("reset", rxBuffer) == 0))
-            {
-                resetSampleFlag = TRUE;
-                uartTxMode = UART_NONE;
-            }
-            else
+            text++;
+        }
+        value = 0;
+        digits = 0;
+        while((*text >= '0') && (*text <= '9') && (digits < 5u))
+        {
+            value = (value * 10) + (*text - '0');
+            text++;
+            digits++;
+        }
+        if(negative == TRUE)
+        {
+            value = -value;
+        }
+        if((digits == 0u) || (value > INT16_MAX) || (value <= last) ||
+           ((numSamples + count) >= SAMPLE_TABLE_MAX))
+        {
+            return FALSE;
+        }
+        points[count++] = (int16_t)value;
+        last = value;
+    } while(*text++ == ',');
+
+    if(text[-1] != '\0')
+    {
+        return FALSE;
+    }
+    memcpy(&arrayAxisLabel[numSamples], points, count * sizeof(int16_t));
+    numSamples += count;
+    return TRUE;
+}
+
+/*******************************************************************************
+* Function Name: dispatch_table_cmd
+********************************************************************************
+* Summary:
+* This function executes the sample table commands. The table can not be
+* changed while a sweep runs.
+*
+* Parameters:
+*    args    Command line after "table".
+*
+* Return:
+*  TRUE if the command was valid, FALSE otherwise.
+*******************************************************************************/
+static uint8_t dispatch_table_cmd(const char *args)
+{
+    uint8_t valid = TRUE;
+
+    if(strcmp("", args) == 0)
+    {
+        display_sample_table();
+    }
+    else if(TRUE == sweep_is_active())
+    {
+        valid = FALSE;
+    }
+    else if(strcmp(" new", args) == 0)
+    {
+        numSamples = 0;
+        resetSampleFlag = TRUE;
+    }
+    else if(strncmp(" add ", args, 5) == 0)
+    {
+        valid = add_table_points(&args[5]);
+    }
+    else if((strcmp(" save", args) == 0) && (numSamples > 0u))
+    {
+        store_sample_table();
+        display_sample_table();
+    }
+    else if(strcmp(" default", args) == 0)
+    {
+        memcpy(arrayAxisLabel, defaultAxisLabel, sizeof(defaultAxisLabel));
+        numSamples = sizeof(defaultAxisLabel) / sizeof(defaultAxisLabel[0]);
+        resetSampleFlag = TRUE;
+        display_sample_table();
+    }
+    else
+    {
+        valid = FALSE;
+    }
+    return valid;
+}
+
+/*******************************************************************************
+* Function Name: dispatch_log_cmd
+********************************************************************************
+* Summary:
+* This function executes the flash log commands.
+*
+* Parameters:
+*    args    Command line after "log".
+*
+* Return:
+*  TRUE if the command was valid, FALSE otherwise.
+*******************************************************************************/
+static uint8_t dispatch_log_cmd(const char *args)
+{
+    uint8_t valid = TRUE;
+    uint32_t fromS = 0u;
+    uint32_t toS = UINT32_MAX;
+
+    if(strcmp("", args) == 0)
+    {
+        datalog_display_status();
+    }
+    else if(strcmp(" flush", args) == 0)
+    {
+        datalog_flush();
+        datalog_display_status();
+    }
+    else if(strncmp(" dump", args, 5) == 0)
+    {
+        /* Optional time range in seconds of log time */
+        args += 5;
+        if(*args == ' ')
+        {
+            args = parse_uint(args + 1, &fromS);
+        }
+        if((args != NULL) && (*args == ' '))
+        {
+            args = parse_uint(args + 1, &toS);
+        }
+        if((args != NULL) && (*args == '\0'))
+        {
+            uartTxMode = UART_NONE;
+            datalog_download(fromS, toS);
+        }
+        else
+        {
+            valid = FALSE;
+        }
+    }
+    else
+    {
+        valid = FALSE;
+    }
+    return valid;
+}
+
+/*******************************************************************************
+* Function Name: dispatch_alarm_cmd
+********************************************************************************
+* Summary:
+* This function executes the alarm commands.
+*
+* Parameters:
+*    args    Command line after "alarm".
+*
+* Return:
+*  TRUE if the command was valid, FALSE otherwise.
+*******************************************************************************/
+static uint8_t dispatch_alarm_cmd(const char *args)
+{
+    uint32_t value;
+    size_t length;
+
+    if(strcmp("", args) == 0)
+    {
+        alarm_display();
+        return TRUE;
+    }
+    if(strcmp(" save", args) == 0)
+    {
+        alarm_store();
+        alarm_display();
+        return TRUE;
+    }
+    if((strncmp(" hyst ", args, 6) == 0) && (TRUE == parse_uint_arg(&args[6], &value)))
+    {
+        return (value <= UINT8_MAX) ? alarm_set_hysteresis((uint8_t)value) : FALSE;
+    }
+    for(uint8_t i = 0; i < ALARM_COUNT; i++)
+    {
+        /* " NAME SENSOR" or " NAME off" */
+        length = strlen(alarmName[i]);
+        if((args[0] == ' ') && (strncmp(alarmName[i], &args[1], length) == 0) && (args[length + 1u] == ' '))
+        {
+            args += length + 2u;
+            if(strcmp("off", args) == 0)
             {
-                Cy_SCB_UART_PutString(CYBSP_UART_HW, "Command Error");
-                Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n");
+                return alarm_set_sensor(i, ALARM_SENSOR_OFF);
             }
-
-            bufferIndex = 0;
-            memset(rxBuffer, '\0', strlen(rxBuffer));
+            return ((TRUE == parse_uint_arg(args, &value)) && (value < NUMSENSORS)) ?
+                   alarm_set_sensor(i, (uint8_t)value) : FALSE;
         }
+    }
+    return FALSE;
+}
 
+/*******************************************************************************
+* Function Name: dispatch_wall_cmd
+********************************************************************************
+* Summary:
+* This function executes the wall commands.
+*
+* Parameters:
+*    args    Command line after "wall".
+*
+* Return:
+*  TRUE if the command was valid, FALSE otherwise.
+*******************************************************************************/
+static uint8_t dispatch_wall_cmd(const char *args)
+{
+    uint32_t thickness;
+    uint32_t permittivity;
+
+    if(strcmp("", args) == 0)
+    {
+        wall_display();
+        return TRUE;
+    }
+    if(args[0] != ' ')
+    {
+        return FALSE;
+    }
+    args = parse_tenths(&args[1], &thickness);
+    if((args == NULL) || (args[0] != ' '))
+    {
+        return FALSE;
+    }
+    args = parse_tenths(&args[1], &permittivity);
+    if((args == NULL) || (args[0] != '\0') || (FALSE == wall_set(thickness, permittivity)))
+    {
+        return FALSE;
+    }
+    wall_display();
+    return TRUE;
+}
+
+/*******************************************************************************
+* Function Name: display_lazy
+********************************************************************************
+* Summary:
+* This function displays the lazy mode, its noise band, the frames processed
+* in lazy mode and the frames in which no sensor changed.
+*
+*******************************************************************************/
+static void display_lazy(void)
+{
+    hal_uart_put_string("Lazy=");
+    hal_uart_put_string((levelLazy == TRUE) ? "on" : "off");
+    hal_uart_put_string(" Band=");
+    display_decimal_val(levelLazyBand, 0);
+    hal_uart_put_string(" Frames=");
+    display_decimal_val((int32_t)levelLazyFrames, 0);
+    hal_uart_put_string(" Avoided=");
+    display_decimal_val((int32_t)levelLazyAvoided, 0);
+    hal_uart_put_string("\r\n");
+}
+
+/*******************************************************************************
+* Function Name: dispatch_uart_cmd
+********************************************************************************
+* Summary:
+* This function executes a complete command line.
+*
+* Parameters:
+*    cmd    Null terminated command line without the line terminator.
+*
+* Return:
+*  void
+*******************************************************************************/
+void dispatch_uart_cmd(const char *cmd)
+{
+    uint32_t value;
+
+    if(strcmp("cal", cmd) == 0)
+    {
+        cal_flag = TRUE;
+    }
+    else if(strcmp("stop", cmd) == 0)
+    {
+        uartTxMode = UART_NONE;
+    }
+    else if(strcmp("csv", cmd) == 0)
+    {
+        uartTxMode = UART_CSVINIT;
+    }
+    else if(strcmp("basic", cmd) == 0)
+    {
+        uartTxMode = UART_BASIC;
+    }
+    else if((strcmp("", cmd) == 0) && (TRUE == sweep_is_active()))
+    {
+        sweep_trigger();
+    }
+    else if(strcmp("", cmd) == 0)
+    {
+        storeSampleFlag = TRUE;
+        uartTxMode = UART_NONE;
+    }
+    else if((strcmp("reset", cmd) == 0))
+    {
+        sweep_abort();
+        resetSampleFlag = TRUE;
+        uartTxMode = UART_NONE;
+    }
+    else if((strncmp("table", cmd, 5) == 0) && (TRUE == dispatch_table_cmd(&cmd[5])))
+    {
+        /* Executed by dispatch_table_cmd() */
+    }
+    else if(strcmp("hist", cmd) == 0)
+    {
+        history_display_stats(0u);
+    }
+    else if((strncmp("hist ", cmd, 5) == 0) && (TRUE == parse_uint_arg(&cmd[5], &value)))
+    {
+        history_display_stats(value);
+    }
+    else if(strcmp("hist dump", cmd) == 0)
+    {
+        uartTxMode = UART_NONE;
+        history_download();
+    }
+    else if(strcmp("hist clear", cmd) == 0)
+    {
+        history_clear();
+    }
+    else if((strncmp("log", cmd, 3) == 0) && (TRUE == dispatch_log_cmd(&cmd[3])))
+    {
+        /* Executed by dispatch_log_cmd() */
+    }
+    else if((strcmp("sweep", cmd) == 0) && (numSamples > 0u))
+    {
+        sweep_start(0u);
+    }
+    else if((strncmp("sweep ", cmd, 6) == 0) && (TRUE == parse_uint_arg(&cmd[6], &value)) &&
+            (value > 0u) && (value <= SWEEP_FRAMES_MAX) && (numSamples > 0u))
+    {
+        sweep_start((uint8_t)value);
+    }
+    else if((strncmp("alarm", cmd, 5) == 0) && (TRUE == dispatch_alarm_cmd(&cmd[5])))
+    {
+        /* Executed by dispatch_alarm_cmd() */
+    }
+    else if(strcmp("selftest", cmd) == 0)
+    {
+        selftestFlag = TRUE;
+        uartTxMode = UART_NONE;
+    }
+    else if(strcmp("acquire", cmd) == 0)
+    {
+        acquireFlag = TRUE;
+    }
+    else if(strcmp("liquid", cmd) == 0)
+    {
+        liquid_display();
+    }
+    else if(strcmp("liquid auto", cmd) == 0)
+    {
+        liquid_set_auto();
+        liquid_display();
+    }
+    else if((strncmp("liquid ", cmd, 7) == 0) && (TRUE == liquid_set_class(&cmd[7])))
+    {
+        liquid_display();
+    }
+    else if((strncmp("wall", cmd, 4) == 0) && (TRUE == dispatch_wall_cmd(&cmd[4])))
+    {
+        /* Executed by dispatch_wall_cmd() */
+    }
+    else if(strcmp("tilt", cmd) == 0)
+    {
+        tilt_display();
+    }
+    else if(strcmp("tilt on", cmd) == 0)
+    {
+        tiltEnable = TRUE;
+    }
+    else if(strcmp("tilt off", cmd) == 0)
+    {
+        tiltEnable = FALSE;
+    }
+    else if(strcmp("edge", cmd) == 0)
+    {
+        edge_display();
+    }
+    else if(strcmp("edge on", cmd) == 0)
+    {
+        edgeEnable = TRUE;
+    }
+    else if(strcmp("edge off", cmd) == 0)
+    {
+        edgeEnable = FALSE;
+    }
+    else if(strcmp("lazy", cmd) == 0)
+    {
+        display_lazy();
+    }
+    else if(strcmp("lazy on", cmd) == 0)
+    {
+        level_set_lazy(TRUE, levelLazyBand);
+    }
+    else if(strcmp("lazy off", cmd) == 0)
+    {
+        level_set_lazy(FALSE, levelLazyBand);
+    }
+    else if((strncmp("lazy band ", cmd, 10) == 0) && (TRUE == parse_uint_arg(&cmd[10], &value)) &&
+            (value <= LEVEL_LAZY_BAND_MAX))
+    {
+        level_set_lazy(levelLazy, (uint16_t)value);
+    }
+    else if(strcmp("stats", cmd) == 0)
+    {
+        stats_display();
+    }
+    else if((strncmp("stats window ", cmd, 13) == 0) && (TRUE == parse_uint_arg(&cmd[13], &value)) &&
+            (TRUE == stats_set_window(value)))
+    {
+        /* Statistics restarted */
+    }
+    else if((strcmp("stats wet", cmd) == 0) && (TRUE == stats_capture_wet()))
+    {
+        stats_display();
+    }
+    else
+    {
+        hal_uart_put_string("Command Error");
+        hal_uart_put_string("\r\n");
     }
 }
 /********************************************************************************
@@ -401,12 +1234,12 @@ void receive_uart_cmd(void)
 *********************************************************************************
 * Summary:
 * This function displays the decimal representation of a fixed precision int32_t
-* variable.
+* variable. Negative numbers are shown as sign and magnitude.
 *
 * Parameters:
 *  int32_t number: Number to be displayed in decimal.
-*  int32_t fixed_shift: Number of bits for fractional portion of number.
-*  int8_t num_decimal: Number of decimal digits after the decimal point to display.
+*  int32_t fixed_shift: Number of bits for fractional portion of number (0..31).
+*  int8_t num_decimal: Number of decimal digits after the decimal point to display (0..9).
 *
 * Note:
 *  If error occurs interrupts are disabled.
@@ -415,33 +1248,42 @@ void receive_uart_cmd(void)
 void display_decimal_fixed_val(int32_t number, uint8_t fixed_shift, uint8_t num_decimal)
 {
     int8_t i = 0;
-    int64_t decimal_num = 0;
-    int32_t dec_digits = 1;
+    uint64_t decimal_num = 0;
+    uint32_t dec_digits = 1;
+    uint32_t fraction_mask = 0;
+    uint32_t magnitude = (uint32_t)number;
 
-    /* Check for out of range parameters */
-    if(fixed_shift > 32)
+    /* Check for out of range parameters. Shifting an int32_t by 32 is undefined. */
+    if(fixed_shift > 31)
     {
-        fixed_shift = 32;
+        fixed_shift = 31;
     }
     if(num_decimal > 9)
     {
         num_decimal = 9;
     }
 
-    /* Display whole number part of value */
-    display_decimal_val(number >> fixed_shift, 0);
+    /* Display sign and whole number part of value */
+    if(number < 0)
+    {
+        magnitude = 0u - magnitude;
+        hal_uart_put('-');
+    }
+    display_unsigned_val(magnitude >> fixed_shift, 0);
     /* Display fractional part of number if required */
     if(num_decimal > 0)
     {
-        Cy_SCB_UART_Put(CYBSP_UART_HW, '.');
+        hal_uart_put('.');
         dec_digits = 1;
         /* Calculate fractional portion scaling multiplier */
         for(i = 0; i < num_decimal; i++)
         {
             dec_digits *= 10;
         }
-        decimal_num = ((number & (0xFFFFFFFF >> (32 - fixed_shift))) * dec_digits) >> fixed_shift;
-        display_decimal_val(decimal_num, num_decimal);
+        /* Fraction bits scaled in 64 bits; the result is below dec_digits */
+        fraction_mask = (fixed_shift == 0) ? 0u : (0xFFFFFFFFu >> (32 - fixed_shift));
+        decimal_num = ((uint64_t)(magnitude & fraction_mask) * dec_digits) >> fixed_shift;
+        display_unsigned_val((uint32_t)decimal_num, num_decimal);
     }
 }
 
@@ -464,41 +1306,44 @@ void display_next_level_val(void)
     static uint16_t sampleIndex;
 
     /* Check if we should output sensor level data */
+    if((storeSampleFlag == TRUE) && (sampleIndex >= numSamples))
+    {
+        hal_uart_put_string("End of sample table");
+        hal_uart_put_string("\r\n");
+        storeSampleFlag = FALSE;
+    }
     if(storeSampleFlag == TRUE)
     {
         uartTxMode = UART_NONE;
 
         if(sampleIndex == 0)
         {
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, "PresetMm,");
-            for(i = 1; i < NUMSENSORS; i++)
+            hal_uart_put_string("PresetMm,");
+            for(i = 0; i < NUMSENSORS; i++)
             {
-                Cy_SCB_UART_PutString(CYBSP_UART_HW, "SenDiff");
+                hal_uart_put_string("SenDiff");
                 display_decimal_val(i, 0);
-                Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+                hal_uart_put_string(",");
             }
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, "Level%, LevelMm");
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n");
+            hal_uart_put_string("Level%, LevelMm");
+            hal_uart_put_string("\r\n");
         }
         display_decimal_val(arrayAxisLabel[sampleIndex], 0);
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
-        for(i = 1; i < NUMSENSORS; i++)
+        hal_uart_put_string(",");
+        level_require_processed();
+        for(i = 0; i < NUMSENSORS; i++)
         {
             display_decimal_val(sensorProcessed[i], 0);
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+            hal_uart_put_string(",");
         }
         display_decimal_fixed_val(levelPercent, 8, 1);
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, ",");
+        hal_uart_put_string(",");
         /* Transmit current liquid level mm */
         display_decimal_fixed_val(levelMm, 8, 1);
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n");
+        hal_uart_put_string("\r\n");
 
-        /* Increment and limit array index */
+        /* Move to the next preset of the sample table */
         sampleIndex += 1;
-        if(sampleIndex >= NUM_SAMPLES)
-        {
-            sampleIndex = NUM_SAMPLES - 1;
-        }
 
         /* Clear flag to allow user to press for next store request */
         storeSampleFlag = FALSE;
@@ -507,8 +1352,8 @@ void display_next_level_val(void)
     if(resetSampleFlag == TRUE)
     {
         sampleIndex = 0;
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, "Reset Test Level");
-        Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n");
+        hal_uart_put_string("Reset Test Level");
+        hal_uart_put_string("\r\n");
         /* Clear flags to allow user to press for next store request */
         resetSampleFlag = FALSE;
         storeSampleFlag = FALSE;
@@ -44,7 +44,7 @@
 #ifndef SOURCE_INTERFACE_H_
 #define SOURCE_INTERFACE_H_
 
-#include "cy_em_eeprom.h"
+#include "level.h"
 
 /*******************************************************************************
 * Global constants
@@ -53,51 +53,55 @@
 #define TRUE                (1u)
 #define FALSE               (0u)
 
-/* Liquid Level constants */
-#define NUMSENSORS          (12u)          /* Number of CapSense sensors */
-
 /* UART constants */
+#define UART_RX_BUFFER_SIZE (64u)       /* Longest command line plus terminator */
 #define UART_NONE           (0u)
 #define UART_BASIC          (1u)
 #define UART_CSVINIT        (2u)
 #define UART_CSV            (3u)
 
-/* Logical Size of Emulated EEPROM in bytes */
-#define LOGICAL_EM_EEPROM_SIZE      (32u)
+/* Logical Size of Emulated EEPROM in bytes. Holds one empty offset per sensor. */
+#define LOGICAL_EM_EEPROM_SIZE      (NUMSENSORS * sizeof(int32_t))
 #define LOGICAL_EM_EEPROM_START     (0u)
 
-/* Emulated EEPROM Configuration details. All the sizes mentioned are in bytes.
- * For details on how to configure these values refer to cy_em_eeprom.h. The
- * middleware documentation is provided in Emulated EEPROM API Reference Manual.
- * The user can access it from the Documentation section in the Quick Panel.
+/* Sample table of level presets in mm for the characterization log and sweep.
+ * Stored in Emulated EEPROM after the calibration values.
  */
-#define EM_EEPROM_SIZE              CY_EM_EEPROM_FLASH_SIZEOF_ROW
-#define BLOCKING_WRITE              (1u)
-#define REDUNDANT_COPY              (1u)
-#define WEAR_LEVELLING_FACTOR       (2u)
-#define SIMPLE_MODE                 (0u)
+#define SAMPLE_TABLE_MAX            (32u)
+#define SAMPLE_TABLE_START          (LOGICAL_EM_EEPROM_START + LOGICAL_EM_EEPROM_SIZE)
+#define SAMPLE_TABLE_SIZE           (sizeof(sample_table_t))
+
+/* Alarm configuration, stored after the sample table. See alarm.h. */
+#define ALARM_CONFIG_START          (SAMPLE_TABLE_START + SAMPLE_TABLE_SIZE)
+
+/* Liquid configuration, stored after the alarm configuration. See liquid.h. */
+#define LIQUID_CONFIG_START         (ALARM_CONFIG_START + ALARM_CONFIG_SIZE)
 
-#define EM_EEPROM_PHYSICAL_SIZE     (CY_EM_EEPROM_GET_PHYSICAL_SIZE(EM_EEPROM_SIZE, SIMPLE_MODE, WEAR_LEVELLING_FACTOR, REDUNDANT_COPY))
+/* Wall configuration, stored after the liquid configuration. See wall.h. */
+#define WALL_CONFIG_START           (LIQUID_CONFIG_START + LIQUID_CONFIG_SIZE)
 
-#define NUM_SAMPLES                  (20u)
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Sample table as stored in Emulated EEPROM */
+typedef struct
+{
+    uint16_t count;                         /* Number of valid presets */
+    uint16_t check;                         /* SAMPLE_TABLE_CHECK plus count and presets */
+    int16_t labelMm[SAMPLE_TABLE_MAX];      /* Presets in increasing order */
+} sample_table_t;
 
 /*******************************************************************************
 * External variables
 *******************************************************************************/
-extern int32_t sensorEmptyOffset[];
-extern int32_t sensorEmptyOffset_2[];
-extern int32_t sensorDiff[NUMSENSORS];
-extern cy_stc_eeprom_context_t em_eeprom_context;
 extern uint8_t uartTxMode;
-extern int32_t levelPercent;
-extern int32_t levelMm;
-extern int32_t sensorRaw[NUMSENSORS]; 
-extern int32_t sensorDiff[NUMSENSORS];
-extern int32_t sensorProcessed[NUMSENSORS];
-extern uint8_t sensorActiveCount;
 extern uint8_t cal_flag;
 extern uint8_t storeSampleFlag;
+extern uint8_t selftestFlag;
+extern uint8_t acquireFlag;
 extern uint8_t resetSampleFlag;
+extern int16_t arrayAxisLabel[SAMPLE_TABLE_MAX];
+extern uint8_t numSamples;
 
 
 /*******************************************************************************
@@ -111,7 +115,13 @@ void display_cur_liquid_level(void);
 void display_decimal_fixed_val(int32_t number, uint8_t fixed_shift, uint8_t num_decimal);
 void display_next_level_val(void);
 void receive_uart_cmd(void);
+void assemble_uart_cmd(uint32_t read_data);
+void dispatch_uart_cmd(const char *cmd);
 void store_calibration(void);
+void load_calibration(void);
+void load_sample_table(void);
+void store_sample_table(void);
+void display_sample_table(void);
 
 #endif /* SOURCE_INTERFACE_H_ */
 
@@ -0,0 +1,555 @@
+/*******************************************************************************
+* File Name: level.c
+*
+* Description: This file contains the liquid level computation pipeline. It
+*              turns sensor raw counts into the number of submerged sensors
+*              and the liquid level in mm and percent.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "level.h"
+#include "interface.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* The wet mask is a uint16_t and the level table has 32 rows */
+#if (NUMSENSORS > 16u) || (SENSOR_HEIGHT_UNITS > 31u)
+#error "The wet mask and level table are too small for the probe"
+#endif
+
+/* Level in mm and percent of a submerged height in half middle sensor heights,
+ * as level_compute() computes them. Fixed precision 24.8.
+ */
+#define LEVEL_MM_UNROUNDED(units)   ((int32_t)(units) * (SENSORHEIGHT >> 1))
+#define LEVEL_MM(units)             ((LEVEL_MM_UNROUNDED(units) > (((int32_t)LEVELMM_MAX << 8) - (SENSORHEIGHT >> 2))) ? \
+                                     ((int32_t)LEVELMM_MAX << 8) : LEVEL_MM_UNROUNDED(units))
+#define LEVEL_PERCENT(units)        ((LEVEL_MM(units) * 100) / (int32_t)LEVELMM_MAX)
+#define LEVEL_ENTRY(units)          {LEVEL_MM(units), LEVEL_PERCENT(units)}
+#define LEVEL_ENTRY4(units)         LEVEL_ENTRY(units), LEVEL_ENTRY((units) + 1), \
+                                    LEVEL_ENTRY((units) + 2), LEVEL_ENTRY((units) + 3)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    int32_t mm;
+    int32_t percent;
+} level_entry_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Number of sensors currently submerged */
+uint8_t sensorActiveCount = 0u;
+int32_t levelPercent = 0u;                    /* fixed precision 24.8 */
+int32_t levelMm = 0u;                         /* fixed precision 24.8 */
+/* Height of a single sensor. Fixed precision 24.8 */
+int32_t sensorHeight = SENSORHEIGHT;
+
+/* Liquid Level variables */
+/* Raw counts of frames not taken from the sensor driver (bench, host tools) */
+uint16_t sensorRaw[NUMSENSORS] = {0u};
+/* Sensor counts when empty to calculate diff counts. Loaded from EEPROM array */
+uint16_t sensorEmptyOffset[NUMSENSORS] = {0u};
+/* Scaling factor to normalize sensor full scale counts. 0x0100 = 1.0 in fixed precision 8.8.
+ * Points to the generated flash table unless a tool substitutes its own.
+ */
+const int16_t *sensorScale = sensorScaleDefault;
+/* Processed count above which a sensor is submerged. SENSORLIMIT unless the
+ * detected liquid class sets its own.
+ */
+int16_t sensorLimit = SENSORLIMIT;
+/* Normalized difference counts, saturated to the int16_t range */
+int16_t sensorProcessed[NUMSENSORS] = {0u};
+/* Submerged sensors of the frame, bit i for sensor i */
+uint16_t levelWetMask = 0u;
+
+/* levelMm and levelPercent by submerged height in half middle sensor heights */
+static const level_entry_t levelTable[32] =
+{
+    LEVEL_ENTRY4(0), LEVEL_ENTRY4(4), LEVEL_ENTRY4(8), LEVEL_ENTRY4(12),
+    LEVEL_ENTRY4(16), LEVEL_ENTRY4(20), LEVEL_ENTRY4(24), LEVEL_ENTRY4(28),
+};
+
+/* Raw count source, read in place: sensor i is at rawSource[i * rawStride] */
+static const uint16_t *rawSource = sensorRaw;
+static uint8_t rawStride = 1u;
+
+/* Highest raw count of each sensor that is still dry, from the offsets, the
+ * scales and sensorLimit. Set by level_update_thresholds().
+ */
+static int32_t sensorRawLimit[NUMSENSORS];
+/* TRUE while sensorProcessed[] holds the counts of the current frame */
+static uint8_t processedValid = FALSE;
+
+/* Lazy mode: TRUE to run level_process_frame_lazy() instead of
+ * level_process_frame(), and the raw count change that counts as a change
+ */
+uint8_t levelLazy = FALSE;
+uint16_t levelLazyBand = LEVEL_LAZY_BAND;
+/* FALSE if lazy mode found no sensor changed in the current frame */
+uint8_t levelFrameChanged = TRUE;
+/* Frames processed in lazy mode and frames in which no sensor changed */
+uint32_t levelLazyFrames = 0u;
+uint32_t levelLazyAvoided = 0u;
+/* Raw count of each sensor when its wet bit was last evaluated */
+static uint16_t lazyRaw[NUMSENSORS];
+/* FALSE to evaluate every sensor in the next lazy frame */
+static uint8_t lazyValid = FALSE;
+/* Submerged height of the lazy wet mask, in half middle sensor heights */
+static uint8_t lazyUnits = 0u;
+
+
+/*******************************************************************************
+* Function Name: level_scale_sensors
+********************************************************************************
+* Summary:
+*  This function removes the empty offset calibration from the sensor raw
+*  counts and normalizes the sensor full count values. The raw counts are
+*  read in place from the raw count source. The difference counts are not
+*  kept; level_sensor_diff() recomputes them for display. The frame pipeline
+*  does not need the processed counts; call level_require_processed() where
+*  they are read.
+*
+*******************************************************************************/
+void level_scale_sensors(void)
+{
+    const uint16_t *raw = rawSource;
+
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        int32_t processed = (((int32_t)*raw - (int32_t)sensorEmptyOffset[i]) * sensorScale[i]) >> 8;
+
+        /* Only a saturated raw count can leave the int16_t range */
+        if(processed > INT16_MAX)
+        {
+            processed = INT16_MAX;
+        }
+        else if(processed < INT16_MIN)
+        {
+            processed = INT16_MIN;
+        }
+        sensorProcessed[i] = (int16_t)processed;
+        raw += rawStride;
+    }
+    processedValid = TRUE;
+}
+
+/*******************************************************************************
+* Function Name: level_require_processed
+********************************************************************************
+* Summary:
+*  This function computes sensorProcessed[] for the current frame unless it
+*  has been computed already. Call it before reading sensorProcessed[].
+*
+*******************************************************************************/
+void level_require_processed(void)
+{
+    if(processedValid == FALSE)
+    {
+        level_scale_sensors();
+    }
+}
+
+/*******************************************************************************
+* Function Name: level_update_thresholds
+********************************************************************************
+* Summary:
+*  This function converts sensorLimit into a raw count limit per sensor, so
+*  that level_count_mask() classifies the sensors without a multiply. A
+*  sensor is wet when (raw - offset) * scale >> 8 > sensorLimit, that is when
+*  raw - offset reaches ceil((sensorLimit + 1) * 256 / scale). A scale of
+*  zero or less never counts as wet. It must be called whenever
+*  sensorEmptyOffset[], sensorScale or sensorLimit change.
+*
+*******************************************************************************/
+void level_update_thresholds(void)
+{
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        int32_t scale = sensorScale[i];
+        int32_t edge = ((int32_t)sensorLimit + 1) * 256;
+
+        if(scale <= 0)
+        {
+            /* Above any raw count */
+            sensorRawLimit[i] = INT32_MAX;
+            continue;
+        }
+        /* Divide rounding up; C division rounds toward zero */
+        edge = (edge > 0) ? ((edge + scale - 1) / scale) : (edge / scale);
+        sensorRawLimit[i] = (int32_t)sensorEmptyOffset[i] + edge - 1;
+    }
+    processedValid = FALSE;
+    lazyValid = FALSE;
+}
+
+/*******************************************************************************
+* Function Name: level_set_raw_source
+********************************************************************************
+* Summary:
+*  This function selects where the pipeline reads raw counts. The sensor
+*  driver's own data is read in place rather than copied each frame; pass
+*  sensorRaw with a stride of 1 to process frames written to sensorRaw[].
+*
+* Parameters:
+*    raw       Raw count of sensor 0.
+*    stride    Distance between the raw counts of adjacent sensors, in
+*              uint16_t elements.
+*
+*******************************************************************************/
+void level_set_raw_source(const uint16_t *raw, uint8_t stride)
+{
+    rawSource = raw;
+    rawStride = stride;
+    lazyValid = FALSE;
+}
+
+/*******************************************************************************
+* Function Name: level_get_raw_source
+********************************************************************************
+* Summary:
+*  This function returns the raw count source set by level_set_raw_source().
+*
+*******************************************************************************/
+void level_get_raw_source(const uint16_t **raw, uint8_t *stride)
+{
+    *raw = rawSource;
+    *stride = rawStride;
+}
+
+/*******************************************************************************
+* Function Name: level_sensor_raw
+********************************************************************************
+* Summary:
+*  This function returns the raw count of a sensor from the raw count source.
+*
+* Parameters:
+*    sensor    Sensor index, 0 to NUMSENSORS - 1.
+*
+*******************************************************************************/
+uint16_t level_sensor_raw(uint8_t sensor)
+{
+    return rawSource[sensor * rawStride];
+}
+
+/*******************************************************************************
+* Function Name: level_sensor_diff
+********************************************************************************
+* Summary:
+*  This function returns the difference count of a sensor, its raw count
+*  minus its empty offset.
+*
+* Parameters:
+*    sensor    Sensor index, 0 to NUMSENSORS - 1.
+*
+*******************************************************************************/
+int32_t level_sensor_diff(uint8_t sensor)
+{
+    return (int32_t)level_sensor_raw(sensor) - (int32_t)sensorEmptyOffset[sensor];
+}
+
+/*******************************************************************************
+* Function Name: level_sensor_wet
+********************************************************************************
+* Summary:
+*  This function returns TRUE if the raw count of a sensor is above its raw
+*  count limit, as level_count_mask() decides for the whole frame.
+*
+* Parameters:
+*    sensor    Sensor index, 0 to NUMSENSORS - 1.
+*
+*******************************************************************************/
+uint8_t level_sensor_wet(uint8_t sensor)
+{
+    return ((int32_t)level_sensor_raw(sensor) > sensorRawLimit[sensor]) ? TRUE : FALSE;
+}
+
+/*******************************************************************************
+* Function Name: level_count_submerged
+********************************************************************************
+* Summary:
+*  This function finds the number of submerged sensors. The count is in units
+*  of half a middle sensor height. With level_compute() it is the loop form
+*  of level_count_mask() and level_lookup(), which the frame pipeline uses.
+*
+*******************************************************************************/
+void level_count_submerged(void)
+{
+    sensorActiveCount = 0;
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        /* Signed compare: a dry sensor reading below its empty offset has a
+         * negative count and must not be taken as submerged.
+         */
+        if(sensorProcessed[i] > sensorLimit)
+        {
+            /* First and last sensor are half the height of middle sensors */
+            sensorActiveCount += sensorHeightUnits[i];
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: level_count_mask
+********************************************************************************
+* Summary:
+*  This function packs the submerged sensors into levelWetMask straight from
+*  the raw counts, without a multiply or a branch per sensor: the sign of the
+*  raw count limit minus the raw count is the wet bit. It is equivalent to
+*  level_scale_sensors() followed by the compare of level_count_submerged().
+*
+*******************************************************************************/
+void level_count_mask(void)
+{
+    const uint16_t *raw = rawSource;
+    uint32_t mask = 0u;
+
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        /* The limits stay far below 2^31, so the difference cannot overflow */
+        mask |= ((uint32_t)(sensorRawLimit[i] - (int32_t)*raw) >> 31) << i;
+        raw += rawStride;
+    }
+    levelWetMask = (uint16_t)mask;
+}
+
+/*******************************************************************************
+* Function Name: level_lookup
+********************************************************************************
+* Summary:
+*  This function fetches sensorActiveCount, levelMm and levelPercent for
+*  levelWetMask from flash tables: the submerged height of each group of
+*  mask bits from sensorMaskUnits[], then the level of that height from
+*  levelTable[]. The cycle count does not depend on the mask. The results
+*  equal those of level_count_submerged() and level_compute().
+*
+*******************************************************************************/
+void level_lookup(void)
+{
+    uint32_t units = 0u;
+
+    for(uint8_t group = 0; group < SENSOR_MASK_GROUPS; group++)
+    {
+        units += sensorMaskUnits[group][(levelWetMask >> (group * SENSOR_MASK_GROUP_BITS)) &
+                                        ((1u << SENSOR_MASK_GROUP_BITS) - 1u)];
+    }
+    sensorActiveCount = (uint8_t)units;
+    levelMm = levelTable[units].mm;
+    levelPercent = levelTable[units].percent;
+}
+
+/*******************************************************************************
+* Function Name: level_compute
+********************************************************************************
+* Summary:
+*  This function calculates the liquid level in mm and percent from the number
+*  of submerged sensors.
+*
+*******************************************************************************/
+void level_compute(void)
+{
+    /* Calculate liquid level height in mm */
+    levelMm = sensorActiveCount * (sensorHeight >> 1);
+    /* If level is near full value then round to full.
+     * Avoids fixed precision rounding errors.
+     */
+    if(levelMm > ((int32_t)LEVELMM_MAX << 8) - (sensorHeight >> 2))
+    {
+        levelMm = LEVELMM_MAX << 8;
+    }
+
+    /* Calculate level percent. Stored in fixed precision
+     * 24.8 format to hold fractional percent.
+     */
+    levelPercent = (levelMm * 100) / LEVELMM_MAX;
+}
+
+/*******************************************************************************
+* Function Name: level_process_frame
+********************************************************************************
+* Summary:
+*  This function runs the complete level pipeline on the current raw count
+*  frame. The processed counts are left for level_require_processed().
+*
+*******************************************************************************/
+void level_process_frame(void)
+{
+    processedValid = FALSE;
+    levelFrameChanged = TRUE;
+    level_count_mask();
+    level_lookup();
+}
+
+/*******************************************************************************
+* Function Name: level_set_wet_run
+********************************************************************************
+* Summary:
+*  This function sets the level of a probe whose lowest sensors are wet and
+*  the others dry, for a level found without scanning every sensor. The
+*  processed counts and the lazy mode state are not valid for such a frame.
+*
+* Parameters:
+*    count    Number of wet sensors from the bottom, 0 to NUMSENSORS.
+*
+*******************************************************************************/
+void level_set_wet_run(uint8_t count)
+{
+    processedValid = FALSE;
+    lazyValid = FALSE;
+    levelFrameChanged = TRUE;
+    levelWetMask = (uint16_t)((1uL << count) - 1u);
+    level_lookup();
+}
+
+/*******************************************************************************
+* Function Name: level_set_run
+********************************************************************************
+* Summary:
+*  This function sets sensorActiveCount, levelMm and levelPercent for a run
+*  of wet sensors from the bottom, for a level found by another method than
+*  the threshold. levelWetMask keeps the sensors above the threshold.
+*
+* Parameters:
+*    count    Number of wet sensors from the bottom, 0 to NUMSENSORS.
+*
+*******************************************************************************/
+void level_set_run(uint8_t count)
+{
+    uint8_t units = 0u;
+
+    for(uint8_t i = 0; i < count; i++)
+    {
+        units += sensorHeightUnits[i];
+    }
+    sensorActiveCount = units;
+    levelMm = levelTable[units].mm;
+    levelPercent = levelTable[units].percent;
+}
+
+/*******************************************************************************
+* Function Name: level_set_lazy
+********************************************************************************
+* Summary:
+*  This function selects lazy mode and its noise band, and restarts its
+*  counters. The first lazy frame evaluates every sensor.
+*
+* Parameters:
+*    enable    TRUE for lazy mode.
+*    band      Raw count change within which a sensor counts as unchanged.
+*
+*******************************************************************************/
+void level_set_lazy(uint8_t enable, uint16_t band)
+{
+    levelLazy = enable;
+    levelLazyBand = band;
+    levelLazyFrames = 0u;
+    levelLazyAvoided = 0u;
+    lazyValid = FALSE;
+}
+
+/*******************************************************************************
+* Function Name: level_process_frame_lazy
+********************************************************************************
+* Summary:
+*  This function is level_process_frame() for frames that mostly repeat the
+*  previous one. Only a sensor whose raw count has moved more than
+*  levelLazyBand from the count it was last evaluated at gets its wet bit
+*  evaluated again, and the level is looked up again only if the wet mask
+*  changed. A sensor that creeps across its threshold within the band keeps
+*  its bit until it has moved by more than the band. Frames in which no
+*  sensor changed clear levelFrameChanged, so that later stages can keep
+*  their results, and are counted in levelLazyAvoided.
+*
+*******************************************************************************/
+void level_process_frame_lazy(void)
+{
+    const uint16_t *raw = rawSource;
+    uint32_t mask = levelWetMask;
+    uint8_t changed = FALSE;
+
+    processedValid = FALSE;
+    levelFrameChanged = TRUE;
+    levelLazyFrames++;
+    if(lazyValid == FALSE)
+    {
+        for(uint8_t i = 0; i < NUMSENSORS; i++)
+        {
+            lazyRaw[i] = raw[i * rawStride];
+        }
+        lazyValid = TRUE;
+        level_count_mask();
+        level_lookup();
+        lazyUnits = sensorActiveCount;
+        return;
+    }
+
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        int32_t delta = (int32_t)*raw - lazyRaw[i];
+
+        if((delta > (int32_t)levelLazyBand) || (delta < -(int32_t)levelLazyBand))
+        {
+            lazyRaw[i] = *raw;
+            mask = (mask & ~(1uL << i)) | (((uint32_t)(sensorRawLimit[i] - (int32_t)*raw) >> 31) << i);
+            changed = TRUE;
+        }
+        raw += rawStride;
+    }
+
+    if(changed == FALSE)
+    {
+        levelFrameChanged = FALSE;
+        levelLazyAvoided++;
+    }
+    if(mask != levelWetMask)
+    {
+        levelWetMask = (uint16_t)mask;
+        level_lookup();
+        lazyUnits = sensorActiveCount;
+    }
+    else
+    {
+        /* A later stage may have replaced the level of the last frame */
+        sensorActiveCount = lazyUnits;
+        levelMm = levelTable[lazyUnits].mm;
+        levelPercent = levelTable[lazyUnits].percent;
+    }
+}
+
+
+/* [] END OF FILE */
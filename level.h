@@ -0,0 +1,109 @@
+/*******************************************************************************
+* File Name: level.h
+*
+* Description: This file is the public interface of level.c source file.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef SOURCE_LEVEL_H_
+#define SOURCE_LEVEL_H_
+
+#include <stdint.h>
+#include "sensor_table.h"
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Liquid Level constants */
+#define NUMSENSORS          (SENSOR_COUNT) /* Number of CapSense sensors */
+
+/* Default threshold for determining if a sensor is submerged. */
+#define SENSORLIMIT         (71u)
+/* Nominal processed count of a fully submerged sensor */
+#define SENSORFULL          (160)
+#define LEVELMM_MAX         (153u)/* Max sensor height in mm */
+/* Height of a single middle sensor. Fixed precision 24.8 */
+#define SENSORHEIGHT        ((LEVELMM_MAX * 256 * 2) / SENSOR_HEIGHT_UNITS)
+/* Default raw count change that lazy mode takes as a change of a sensor */
+#define LEVEL_LAZY_BAND     (8u)
+#define LEVEL_LAZY_BAND_MAX (1000u)
+
+/*******************************************************************************
+* External variables
+*******************************************************************************/
+extern uint8_t sensorActiveCount;
+extern int32_t levelPercent;
+extern int32_t levelMm;
+extern int32_t sensorHeight;
+extern uint16_t sensorRaw[NUMSENSORS];
+extern uint16_t sensorEmptyOffset[NUMSENSORS];
+extern const int16_t *sensorScale;
+extern int16_t sensorLimit;
+extern int16_t sensorProcessed[NUMSENSORS];
+extern uint16_t levelWetMask;
+extern uint8_t levelLazy;
+extern uint16_t levelLazyBand;
+extern uint8_t levelFrameChanged;
+extern uint32_t levelLazyFrames;
+extern uint32_t levelLazyAvoided;
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void level_scale_sensors(void);
+void level_require_processed(void);
+void level_update_thresholds(void);
+void level_set_raw_source(const uint16_t *raw, uint8_t stride);
+void level_get_raw_source(const uint16_t **raw, uint8_t *stride);
+uint16_t level_sensor_raw(uint8_t sensor);
+int32_t level_sensor_diff(uint8_t sensor);
+void level_count_submerged(void);
+void level_compute(void);
+void level_count_mask(void);
+void level_lookup(void);
+void level_process_frame(void);
+uint8_t level_sensor_wet(uint8_t sensor);
+void level_set_wet_run(uint8_t count);
+void level_set_run(uint8_t count);
+void level_set_lazy(uint8_t enable, uint16_t band);
+void level_process_frame_lazy(void);
+
+#endif /* SOURCE_LEVEL_H_ */
+
+
+/* [] END OF FILE  */
@@ -0,0 +1,369 @@
+/*******************************************************************************
+* File Name: liquid.c
+*
+* Description: This file contains the liquid class detection. When the probe
+*              has been fully submerged for a while, the mean wet response of the
+*              sensors is matched against the known liquid and container
+*              classes, and the thresholds and scales of the best match are used.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "alarm.h"
+#include "liquid.h"
+#include "wall.h"
+
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Seed of the configuration checksum, so that erased storage is rejected */
+#define LIQUID_CONFIG_CHECK     (0x11D0u)
+
+/* Every sensor must respond with at least this processed count, at the
+ * scales of the wall, for the probe to count as full: about a third of the weakest class.
+ */
+#define LIQUID_FULL_FLOOR       (LIQUID_REF_RESPONSE / 16)
+
+/* A class matches if the response is within a quarter of its own, and the
+ * probe is uniform if every sensor is within a third of the probe mean.
+ */
+#define LIQUID_MATCH_TOL_SHIFT  (2u)
+#define LIQUID_PROFILE_TOL      (3)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    const char *name;
+    uint16_t response;      /* Wet response relative to LIQUID_REF_RESPONSE, 8.8 */
+    uint16_t gain;          /* Applied to sensorScaleDefault[], 8.8 */
+    int16_t limit;          /* sensorLimit */
+} liquid_class_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint16_t liquid_config_check(const liquid_config_t *config);
+static void liquid_store(void);
+static void liquid_classify(void);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Liquid and container classes. The response is the wet response through
+ * the container wall relative to water through the reference wall; the wall
+ * is in series with the liquid, so a thicker wall lowers it like a lower
+ * permittivity does. With the wall set, see wall.c, the response is relative
+ * to water through that wall instead. The gain brings the wet response back
+ * to the reference,
+ * and oils, whose films stay on the wall after draining, get more margin.
+ * Water and glycol coolants respond within a few percent of each other and
+ * share a class.
+ */
+static const liquid_class_t liquidClass[LIQUID_CLASS_COUNT] =
+{
+    {"aqueous",         0x0100, 0x0100, SENSORLIMIT},
+    {"aqueous-thick",   0x009A, 0x01AA, SENSORLIMIT},
+    {"oil",             0x004C, 0x035E, 80},
+    {"oil-thick",       0x002E, 0x0591, 90},
+};
+
+static liquid_config_t liquidConfig = {LIQUID_CLASS_DEFAULT, TRUE, 0u};
+
+/* Scales of the active class, sensorScale points here */
+static int16_t liquidScale[NUMSENSORS];
+
+/* Sums of the wet responses while the probe is full, at default scales */
+static int32_t detectSum[NUMSENSORS];
+static uint8_t detectFrames = 0;
+
+/* Last classified response relative to the reference, 8.8. 0 if none yet. */
+static uint16_t liquidResponse = 0;
+
+
+/*******************************************************************************
+* Function Name: liquid_config_check
+********************************************************************************
+* Summary:
+*  This function computes the checksum of a liquid configuration.
+*
+*******************************************************************************/
+static uint16_t liquid_config_check(const liquid_config_t *config)
+{
+    return (uint16_t)(LIQUID_CONFIG_CHECK + ((uint16_t)config->autoDetect << 8) + config->liquidClass);
+}
+
+/*******************************************************************************
+* Function Name: liquid_init
+********************************************************************************
+* Summary:
+*  This function loads the stored liquid class, or the default one, and
+*  applies its threshold and scales.
+*
+*******************************************************************************/
+void liquid_init(void)
+{
+    liquid_config_t config;
+    uint32_t storage_status;
+
+    storage_status = hal_storage_read(LIQUID_CONFIG_START, &config, LIQUID_CONFIG_SIZE);
+    handle_error(storage_status, "Emulated EEPROM Read failed \r\n");
+
+    if((config.check == liquid_config_check(&config)) && (config.liquidClass < LIQUID_CLASS_COUNT) &&
+       (config.autoDetect <= TRUE))
+    {
+        liquidConfig = config;
+    }
+    detectFrames = 0;
+    liquid_apply();
+}
+
+/*******************************************************************************
+* Function Name: liquid_process_frame
+********************************************************************************
+* Summary:
+*  This function adds the frame just processed to the detection while every
+*  sensor is submerged, and classifies the liquid after LIQUID_DETECT_FRAMES
+*  such frames in a row. The responses are taken at the scales of the wall,
+*  so that they do not depend on the active class. It must be called once per
+*  frame.
+*
+*******************************************************************************/
+void liquid_process_frame(void)
+{
+    if(liquidConfig.autoDetect == FALSE)
+    {
+        return;
+    }
+    if(detectFrames == 0u)
+    {
+        memset(detectSum, 0, sizeof(detectSum));
+    }
+
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        int32_t response = (level_sensor_diff(i) * wallScale[i]) >> 8;
+
+        if(response < LIQUID_FULL_FLOOR)
+        {
+            /* Not full, start again */
+            detectFrames = 0;
+            return;
+        }
+        detectSum[i] += response;
+    }
+
+    detectFrames++;
+    if(detectFrames >= LIQUID_DETECT_FRAMES)
+    {
+        liquid_classify();
+        detectFrames = 0;
+    }
+}
+
+/*******************************************************************************
+* Function Name: liquid_classify
+********************************************************************************
+* Summary:
+*  This function matches the mean response of the full probe against the
+*  classes. A profile that is not uniform, for example with the top sensor
+*  only partly submerged, is not classified. The active class is kept while
+*  it still matches, so that a response between two classes does not make
+*  the class change back and forth. A new class is applied and stored.
+*
+*******************************************************************************/
+static void liquid_classify(void)
+{
+    int32_t mean = 0;
+    uint8_t best = liquidConfig.liquidClass;
+    uint32_t bestDistance = UINT32_MAX;
+
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        mean += detectSum[i] / detectFrames;
+    }
+    mean /= NUMSENSORS;
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        int32_t deviation = (detectSum[i] / detectFrames) - mean;
+
+        if(((deviation < 0) ? -deviation : deviation) * LIQUID_PROFILE_TOL > mean)
+        {
+            return;
+        }
+    }
+
+    liquidResponse = (uint16_t)(((mean * 256) + (LIQUID_REF_RESPONSE / 2)) / LIQUID_REF_RESPONSE);
+    for(uint8_t c = 0; c < LIQUID_CLASS_COUNT; c++)
+    {
+        uint32_t response = liquidClass[c].response;
+        uint32_t distance = (liquidResponse > response) ? (liquidResponse - response) : (response - liquidResponse);
+
+        if((distance <= (response >> LIQUID_MATCH_TOL_SHIFT)) &&
+           ((c == liquidConfig.liquidClass) || (bestDistance == UINT32_MAX)))
+        {
+            /* Relative distance, 8.8 */
+            distance = (distance << 8) / response;
+            if((c == liquidConfig.liquidClass) || (distance < bestDistance))
+            {
+                best = c;
+                bestDistance = (c == liquidConfig.liquidClass) ? 0u : distance;
+            }
+        }
+    }
+
+    if(best != liquidConfig.liquidClass)
+    {
+        liquidConfig.liquidClass = best;
+        liquid_apply();
+        liquid_store();
+        hal_uart_put_string("Liquid detected: ");
+        hal_uart_put_string(liquidClass[best].name);
+        hal_uart_put_string("\r\n");
+    }
+}
+
+/*******************************************************************************
+* Function Name: liquid_apply
+********************************************************************************
+* Summary:
+*  This function loads the threshold of the active class, and its gain on the
+*  scales of the wall.
+*
+*******************************************************************************/
+void liquid_apply(void)
+{
+    const liquid_class_t *cls = &liquidClass[liquidConfig.liquidClass];
+
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        int32_t scale = ((int32_t)wallScale[i] * cls->gain) >> 8;
+
+        liquidScale[i] = (scale > INT16_MAX) ? INT16_MAX : (int16_t)scale;
+    }
+    sensorScale = liquidScale;
+    sensorLimit = cls->limit;
+    level_update_thresholds();
+}
+
+/*******************************************************************************
+* Function Name: liquid_store
+********************************************************************************
+* Summary:
+*  This function stores the liquid configuration to emulated EEPROM.
+*
+*******************************************************************************/
+static void liquid_store(void)
+{
+    uint32_t storage_status;
+
+    liquidConfig.check = liquid_config_check(&liquidConfig);
+    storage_status = hal_storage_write(LIQUID_CONFIG_START, &liquidConfig, LIQUID_CONFIG_SIZE);
+    handle_error(storage_status, "Emulated EEPROM Write failed \r\n");
+}
+
+/*******************************************************************************
+* Function Name: liquid_set_class
+********************************************************************************
+* Summary:
+*  This function selects a class by name and turns the detection off.
+*
+* Return:
+*  TRUE if the name is a class, FALSE otherwise.
+*
+*******************************************************************************/
+uint8_t liquid_set_class(const char *name)
+{
+    for(uint8_t c = 0; c < LIQUID_CLASS_COUNT; c++)
+    {
+        if(strcmp(liquidClass[c].name, name) == 0)
+        {
+            liquidConfig.liquidClass = c;
+            liquidConfig.autoDetect = FALSE;
+            liquid_apply();
+            liquid_store();
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/*******************************************************************************
+* Function Name: liquid_set_auto
+********************************************************************************
+* Summary:
+*  This function turns the detection on. The active class is kept until the
+*  next full probe is classified.
+*
+*******************************************************************************/
+void liquid_set_auto(void)
+{
+    liquidConfig.autoDetect = TRUE;
+    detectFrames = 0;
+    liquid_store();
+}
+
+/*******************************************************************************
+* Function Name: liquid_display
+********************************************************************************
+* Summary:
+*  This function displays the active class, the detection mode, the
+*  threshold and the last classified response in percent of the reference.
+*
+*******************************************************************************/
+void liquid_display(void)
+{
+    hal_uart_put_string("Liquid=");
+    hal_uart_put_string(liquidClass[liquidConfig.liquidClass].name);
+    hal_uart_put_string((liquidConfig.autoDetect == TRUE) ? " Mode=auto" : " Mode=fixed");
+    hal_uart_put_string(" Limit=");
+    display_decimal_val(sensorLimit, 0);
+    hal_uart_put_string(" Response%=");
+    display_decimal_fixed_val((int32_t)liquidResponse * 100, 8, 1);
+    hal_uart_put_string("\r\nClasses:");
+    for(uint8_t c = 0; c < LIQUID_CLASS_COUNT; c++)
+    {
+        hal_uart_put_string(" ");
+        hal_uart_put_string(liquidClass[c].name);
+    }
+    hal_uart_put_string("\r\n");
+}
+
+/* [] END OF FILE */
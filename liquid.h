@@ -0,0 +1,95 @@
+/*******************************************************************************
+* File Name: liquid.h
+*
+* Description: This file is the public interface of liquid.c source file.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef SOURCE_LIQUID_H_
+#define SOURCE_LIQUID_H_
+
+#include <stdint.h>
+#include "level.h"
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Liquid classes, see liquidClass[] in liquid.c */
+#define LIQUID_CLASS_COUNT          (4u)
+#define LIQUID_AQUEOUS              (0u)    /* Water and glycol coolants, reference wall */
+#define LIQUID_AQUEOUS_THICK        (1u)    /* Water and coolants, thick wall */
+#define LIQUID_OIL                  (2u)    /* Mineral and vegetable oils, reference wall */
+#define LIQUID_OIL_THICK            (3u)    /* Oils, thick wall */
+#define LIQUID_CLASS_DEFAULT        (LIQUID_AQUEOUS)
+
+/* Processed count of a wet sensor in water through the container wall, with
+ * the scales of the wall
+ */
+#define LIQUID_REF_RESPONSE         (SENSORFULL)
+
+/* Frames the probe must stay fully submerged before it is classified */
+#define LIQUID_DETECT_FRAMES        (50u)
+
+/* Liquid configuration, stored after the alarm configuration */
+#define LIQUID_CONFIG_SIZE          (sizeof(liquid_config_t))
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Liquid configuration as stored in Emulated EEPROM */
+typedef struct
+{
+    uint8_t liquidClass;                    /* LIQUID_* */
+    uint8_t autoDetect;                     /* TRUE to classify when the probe is full */
+    uint16_t check;                         /* LIQUID_CONFIG_CHECK plus the bytes above */
+} liquid_config_t;
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void liquid_init(void);
+void liquid_process_frame(void);
+void liquid_apply(void);
+uint8_t liquid_set_class(const char *name);
+void liquid_set_auto(void);
+void liquid_display(void);
+
+#endif /* SOURCE_LIQUID_H_ */
+
+
+/* [] END OF FILE  */
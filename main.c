@@ -43,94 +43,41 @@
 /*******************************************************************************
  * Include header files
  ******************************************************************************/
-#include "cy_pdl.h"
-#include "cybsp.h"
-#include "cycfg.h"
-#include "cycfg_capsense.h"
-#include "cy_em_eeprom.h"
+#include "hal.h"
+#include "level.h"
 #include "interface.h"
+#include "bench.h"
+#include "sweep.h"
+#include "history.h"
+#include "datalog.h"
+#include "alarm.h"
+#include "liquid.h"
+#include "wall.h"
+#include "tilt.h"
+#include "stats.h"
+#include "selftest.h"
+#include "acquire.h"
+#include "edge.h"
 
 
 /*******************************************************************************
 * Macros
 *******************************************************************************/
-#define CAPSENSE_INTR_PRIORITY    (3u)
-#define CY_ASSERT_FAILED          (0u)
-
-/* EZI2C interrupt priority must be higher than CAPSENSE interrupt. */
-#define EZI2C_INTR_PRIORITY       (2u)
-
-/* Threshold for determining if a sensor is submerged. */
-#define SENSORLIMIT         (71u) 
-#define LEVELMM_MAX         (153u)/* Max sensor height in mm */
-/* Height of a single sensor. Fixed precision 24.8 */
-#define SENSORHEIGHT        ((LEVELMM_MAX * 256) / (NUMSENSORS - 1)) 
-
-/* EEPROM constants */
-#define Em_EEPROM_FLASH_BASE_ADDR        (CYDEV_FLASH_BASE)
-#define Em_EEPROM_FLASH_SIZE             (CYDEV_FLASH_SIZE)
-
 /* UART constants */
 #define UART_DELAY          (100u)  /* Delay in ms to control data logging rate.*/
 
-/* Enable this, if Tuner needs to be enabled */
-#define CAPSENSE_TUNER_EN                            (0u)
+/* Enable this to print the benchmark suite results over UART at startup.
+ * Can also be set from the Makefile: DEFINES=LLS_BENCHMARK_EN=1
+ */
+#ifndef LLS_BENCHMARK_EN
+#define LLS_BENCHMARK_EN    (0u)
+#endif
 
 /*******************************************************************************
 * Global Variables
 ********************************************************************************/
-
-/* Emulated EEPROM configuration and context structure. */
-cy_stc_eeprom_config_t em_eeprom_config =
-{
-    .eepromSize         = EM_EEPROM_SIZE,           /* 256 bytes */
-    .blockingWrite      = BLOCKING_WRITE,           /* Blocking writes enabled */
-    .redundantCopy      = REDUNDANT_COPY,           /* Redundant copy enabled */
-    .wearLevelingFactor = WEAR_LEVELLING_FACTOR,    /* Wear levelling factor of 2 */
-    .simpleMode         = SIMPLE_MODE,              /* Simple mode disabled */
-};
-
-/* Sensor counts when empty to calculate diff counts. Loaded from EEPROM array */
-CY_ALIGN(CY_EM_EEPROM_FLASH_SIZEOF_ROW)
-const uint8_t eepromEmptyOffset[EM_EEPROM_PHYSICAL_SIZE] = {0u};
-
-/* Number of sensors currently submerged */
-uint8_t sensorActiveCount = 0u;               
-int32_t levelPercent = 0u;                    /* fixed precision 24.8 */
-int32_t levelMm = 0u;                         /* fixed precision 24.8 */
-/* Height of a single sensor. Fixed precision 24.8 */
-int32_t sensorHeight = SENSORHEIGHT;          
-
 /* Main loop delay in ms to control UART data log output speed */
 uint16_t delayMs = UART_DELAY;                
-/* Flag to signal when new sensor calibration values should be stored to EEPROM */
-uint8_t cal_flag = FALSE;                      
-
-/* Liquid Level variables */
-int32_t sensorRaw[NUMSENSORS] = {0u};         /* Sensor raw counts */
-int32_t sensorDiff[NUMSENSORS] = {0u};        /* Sensor difference counts */
-/* Sensor counts when empty to calculate diff counts. Loaded from EEPROM array */
-int32_t sensorEmptyOffset[LOGICAL_EM_EEPROM_SIZE] = {0u}; 
-/* Scaling factor to normalize sensor full scale counts. 0x0100 = 1.0 in fixed precision 8.8 */
-int16_t sensorScale[NUMSENSORS] = {0x01D0, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x01C0}; 
-int32_t sensorProcessed[NUMSENSORS] = {0u, 0u}; /* fixed precision 24.8 */
-
-/*******************************************************************************
-* Global Definitions
-*******************************************************************************/
-cy_stc_scb_ezi2c_context_t ezi2c_context;
-cy_stc_eeprom_context_t em_eeprom_context;
-
-/*******************************************************************************
-* Function Prototypes
-*******************************************************************************/
-static void initialize_capsense(void);
-static void capsense_isr(void);
-
-#if CAPSENSE_TUNER_EN
-static void ezi2c_isr(void);
-static void initialize_capsense_tuner(void);
-#endif
 
 
 /*******************************************************************************
@@ -139,10 +86,9 @@ static void initialize_capsense_tuner(void);
 * Summary:
 *  System entrance point. This function performs
 *  - initial setup of device
-*  - initialize CAPSENSE
-*  - initialize tuner communication
-*  - initialize EEPROM
 *  - initialize UART
+*  - initialize EEPROM
+*  - initialize CAPSENSE (and tuner communication)
 *
 * Return:
 *  int
@@ -150,263 +96,146 @@ static void initialize_capsense_tuner(void);
 *******************************************************************************/
 int main(void)
 {
-    cy_rslt_t result = CY_RSLT_SUCCESS;
-    cy_stc_scb_uart_context_t CYBSP_UART_context;
-    cy_en_em_eeprom_status_t em_eeprom_status;
+    uint32_t storage_status;
+    uint32_t sensor_status;
+    hal_sensor_view_t view;
 
-    uint8_t index;
+    /* Initialize the device, board peripherals and UART */
+    hal_init();
 
-    /* Initialize the device and board peripherals */
-    result = cybsp_init();
-
-    /* Board init failed. Stop program execution */
-    if (result != CY_RSLT_SUCCESS)
-    {
-        CY_ASSERT(CY_ASSERT_FAILED);
-    }
+    /* Send a string over serial terminal */
+    hal_uart_put_string("\x1b[2J\x1b[;H");
+    hal_uart_put_string("***************************************************************\r\n");
+    hal_uart_put_string("CE202479 - PSoC 4 Capacitive Liquid Level Sensing\r\n");
+    hal_uart_put_string("***************************************************************\r\n\n");
 
-    /* Configure and enable the UART peripheral */
-    Cy_SCB_UART_Init(CYBSP_UART_HW, &CYBSP_UART_config, &CYBSP_UART_context);
-    Cy_SCB_UART_Enable(CYBSP_UART_HW);
+    display_uart_commands();
 
-    /* Enable global interrupts */
-    __enable_irq();
+    /* Initialize Emulated EEPROM */
+    storage_status = hal_storage_init();
+    handle_error(storage_status, "Emulated EEPROM Initialization Error \r\n");
 
-    /* Send a string over serial terminal */
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "\x1b[2J\x1b[;H");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "***************************************************************\r\n");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "CE202479 - PSoC 4 Capacitive Liquid Level Sensing\r\n");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "***************************************************************\r\n\n");
+    /* Read stored empty offset values from EEPROM */
+    load_calibration();
 
-    display_uart_commands();
     display_current_cal_val();
 
-    /* Initialize the flash start address in Emulated EEPROM configuration
-     * structure
-     */
-    em_eeprom_config.userFlashStartAddr = (uint32_t) eepromEmptyOffset;
+    /* Read the stored sample table, or use the default one */
+    load_sample_table();
+    display_sample_table();
 
-    /* Initialize Emulated EEPROM */
-    em_eeprom_status = Cy_Em_EEPROM_Init(&em_eeprom_config, &em_eeprom_context);
-    handle_error(em_eeprom_status, "Emulated EEPROM Initialization Error \r\n");
+    /* Compensate the default scales for the stored container wall */
+    wall_init();
 
-    /* Read stored empty offset values from EEPROM */
-    for(index = 0; index < NUMSENSORS; index++)
-    {
-        sensorEmptyOffset[index] = ((volatile int16_t *)eepromEmptyOffset)[index];
-    }
+    /* Continue the flash log after its newest row */
+    datalog_init();
+    datalog_display_status();
 
-#if CAPSENSE_TUNER_EN
-    /* Initialize EZI2C */
-    initialize_capsense_tuner();
+#if LLS_BENCHMARK_EN
+    /* Time the pipeline stages before CAPSENSE interrupts are enabled */
+    bench_run(BENCH_ITERATIONS);
 #endif
 
     /* Initialize CAPSENSE */
-    initialize_capsense();
+    sensor_status = hal_sensor_init();
+    if(HAL_SUCCESS != sensor_status)
+    {
+        /* Keep running, so that the sensors can be tuned */
+        hal_uart_put_string("CAPSENSE Initialization Error, check the tuning \r\n");
+    }
+
+    /* Check the sensor pins and electrodes before the first scan */
+    (void)selftest_run(SELFTEST_BUDGET_MS);
+
+    /* Read the raw counts in place from the CAPSENSE sensor context */
+    view = hal_sensor_get_view();
+    level_set_raw_source(view.raw, view.stride);
+
+    /* Load the thresholds and scales of the stored liquid class */
+    liquid_init();
+    liquid_display();
+
+    /* Find the surface with a few single sensor scans before the first full
+     * scan, so that a level is known early
+     */
+    (void)acquire_run();
+    acquire_display();
+
+    /* Evaluate the alarms at the end of every scan */
+    alarm_init();
+    alarm_display();
 
     /* Start the first scan */
-    Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
+    hal_sensor_scan_start();
 
     for (;;)
     {
         /* Check for CapSense scan complete*/
-        if(CY_CAPSENSE_NOT_BUSY == Cy_CapSense_IsBusy(&cy_capsense_context))
+        if(HAL_SENSOR_NOT_BUSY == hal_sensor_is_busy())
         {
             /* Process all widgets */
-            Cy_CapSense_ProcessAllWidgets(&cy_capsense_context);
-            /* Delay to control data logging rate */
-            Cy_SysLib_Delay(delayMs);
+            hal_sensor_process();
 
-            /* Read and store new sensor raw counts, remove empty offset
-             * scalibration from sensor raw counts.
-             */
-            for(uint8_t i = 0; i < NUMSENSORS; i++)
+            if(cal_flag == TRUE)
             {
-                sensorRaw[i] = cy_capsense_tuner.sensorContext[i].raw;
-                sensorDiff[i] = sensorRaw[i];
-
+                cal_flag = FALSE;
+                store_calibration();
             }
 
-                /* Start scan for next iteration */
-                Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
-
-                if(cal_flag == TRUE)
-                {
-                    cal_flag = FALSE;
-                    store_calibration();
-                }
-
-                /* Remove empty offset calibration from sensor raw counts 
-                 * and normalize sensor full count values.
-                 */
-                for(uint8_t i = 0; i < NUMSENSORS; i++)
-                {
-                    sensorDiff[i] -= sensorEmptyOffset[i];
-                    sensorProcessed[i] = (sensorDiff[i] * sensorScale[i]) >> 8;
-                }
-
-                /* Find the number of submerged sensors */
-                sensorActiveCount = 0;
-                for(uint8_t i = 0; i < NUMSENSORS; i++)
-                {
-                    if(sensorProcessed[i] > SENSORLIMIT)
-                    {
-                        /* First and last sensor are half the height of middle sensors */
-                        if((i == 0) || (i == NUMSENSORS - 1))
-                        {
-                            sensorActiveCount += 1;
-                        }
-                        /* Middle sensors are twice the height of 1st and last sensors */
-                        else
-                        {
-                            sensorActiveCount += 2;
-                        }
-                    }
-                }
-
-                /* Calculate liquid level height in mm */
-                levelMm = sensorActiveCount * (sensorHeight >> 1);
-                /* If level is near full value then round to full. 
-                 * Avoids fixed precision rounding errors.
-                 */
-                if(levelMm > ((int32_t)LEVELMM_MAX << 8) - (sensorHeight >> 2))
-                {
-                    levelMm = LEVELMM_MAX << 8;
-                }
-
-                /* Calculate level percent. Stored in fixed precision 
-                 * 24.8 format to hold fractional percent.
-                 */
-                levelPercent = (levelMm * 100) / LEVELMM_MAX;
-
-            /* Report level and process UART interfaces */
-            display_cur_liquid_level();
-#if CAPSENSE_TUNER_EN
-            /* Establishes synchronized communication with the CapSense Tuner tool */
-            Cy_CapSense_RunTuner(&cy_capsense_context);
-#endif
-
-       }
-
-    }
-}
-
-/*******************************************************************************
-* Function Name: initialize_capsense
-********************************************************************************
-* Summary:
-*  This function initializes the CAPSENSE and configures the CAPSENSE
-*  interrupt.
-*
-*******************************************************************************/
-static void initialize_capsense(void)
-{
-    cy_capsense_status_t status = CY_CAPSENSE_STATUS_SUCCESS;
-
-    /* CAPSENSE interrupt configuration */
-    const cy_stc_sysint_t capsense_interrupt_config =
-    {
-        .intrSrc = CYBSP_CAPSENSE_IRQ,
-        .intrPriority = CAPSENSE_INTR_PRIORITY,
-    };
+            /* Remove empty offset calibration, normalize and compute level */
+            if(levelLazy == TRUE)
+            {
+                level_process_frame_lazy();
+            }
+            else
+            {
+                level_process_frame();
+            }
 
-    /* Capture the CSD HW block and initialize it to the default state. */
-    status = Cy_CapSense_Init(&cy_capsense_context);
+            /* Locate the surface at the largest rise between adjacent sensors */
+            edge_process_frame();
 
-    if (CY_CAPSENSE_STATUS_SUCCESS == status)
-    {
-        /* Initialize CAPSENSE interrupt */
-        Cy_SysInt_Init(&capsense_interrupt_config, capsense_isr);
-        NVIC_ClearPendingIRQ(capsense_interrupt_config.intrSrc);
-        NVIC_EnableIRQ(capsense_interrupt_config.intrSrc);
+            /* Estimate the level from the partially wet sensors */
+            tilt_process_frame();
 
-        /* Initialize the CAPSENSE firmware modules. */
-        status = Cy_CapSense_Enable(&cy_capsense_context);
-    }
+            /* Detect the liquid class while the probe is full */
+            liquid_process_frame();
 
-    if(status != CY_CAPSENSE_STATUS_SUCCESS)
-    {
-        /* This status could fail before tuning the sensors correctly.
-         * Ensure that this function passes after the CAPSENSE sensors are tuned
-         * as per procedure give in the Readme.md file */
-    }
-}
+            /* Keep the level in the RAM history */
+            history_process_frame();
+            datalog_process_frame();
 
+            /* Add the frame to the noise statistics */
+            stats_process_frame();
 
-/*******************************************************************************
-* Function Name: capsense_isr
-********************************************************************************
-* Summary:
-* Wrapper function for handling interrupts from CAPSENSE block.
-*
-*******************************************************************************/
-static void capsense_isr(void)
-{
-    Cy_CapSense_InterruptHandler(CYBSP_CAPSENSE_HW, &cy_capsense_context);
-}
+            /* Average the frame into the characterization sweep, if running */
+            sweep_process_frame();
 
-#if CAPSENSE_TUNER_EN
-/*******************************************************************************
-* Function Name: initialize_capsense_tuner
-********************************************************************************
-* Summary:
-* - EZI2C module to communicate with the CAPSENSE Tuner tool.
-*
-*******************************************************************************/
-static void initialize_capsense_tuner(void)
-{
-    cy_en_scb_ezi2c_status_t status = CY_SCB_EZI2C_SUCCESS;
-
-    /* EZI2C interrupt configuration structure */
-    const cy_stc_sysint_t ezi2c_intr_config =
-    {
-        .intrSrc = CYBSP_EZI2C_IRQ,
-        .intrPriority = EZI2C_INTR_PRIORITY,
-    };
-
-    /* Initialize the EzI2C firmware module */
-    status = Cy_SCB_EZI2C_Init(CYBSP_EZI2C_HW, &CYBSP_EZI2C_config, &ezi2c_context);
-
-    if(status != CY_SCB_EZI2C_SUCCESS)
-    {
-        CY_ASSERT(CY_ASSERT_FAILED);
-    }
+            /* Report level and process UART interfaces */
+            display_cur_liquid_level();
 
-    Cy_SysInt_Init(&ezi2c_intr_config, ezi2c_isr);
-    NVIC_EnableIRQ(ezi2c_intr_config.intrSrc);
+            if(selftestFlag == TRUE)
+            {
+                selftestFlag = FALSE;
+                (void)selftest_run(SELFTEST_BUDGET_MS);
+            }
 
-    /* Set the CAPSENSE data structure as the I2C buffer to be exposed to the
-     * master on primary slave address interface. Any I2C host tools such as
-     * the Tuner or the Bridge Control Panel can read this buffer but you can
-     * connect only one tool at a time.
-     */
-    Cy_SCB_EZI2C_SetBuffer1(CYBSP_EZI2C_HW, (uint8_t *)&cy_capsense_tuner,
-                            sizeof(cy_capsense_tuner), sizeof(cy_capsense_tuner),
-                            &ezi2c_context);
+            if(acquireFlag == TRUE)
+            {
+                acquireFlag = FALSE;
+                (void)acquire_run();
+                acquire_display();
+            }
 
-    /* Enables the SCB block for the EZI2C operation. */
-    Cy_SCB_EZI2C_Enable(CYBSP_EZI2C_HW);
+            /* Start scan for next iteration. The raw counts of this frame are
+             * read in place, so the scan starts after their last reader.
+             */
+            hal_sensor_scan_start();
 
-    /* EZI2C initialization failed */
-    if(status != CY_SCB_EZI2C_SUCCESS)
-    {
-        CY_ASSERT(CY_ASSERT_FAILED);
+            /* Delay to control data logging rate. The scan runs meanwhile. */
+            hal_delay_ms(delayMs);
+        }
     }
 }
 
-
-/*******************************************************************************
-* Function Name: ezi2c_isr
-********************************************************************************
-* Summary:
-*  Wrapper function for handling interrupts from EZI2C block.
-*
-*******************************************************************************/
-static void ezi2c_isr(void)
-{
-    Cy_SCB_EZI2C_Interrupt(CYBSP_EZI2C_HW, &ezi2c_context);
-}
-
-#endif /* CAPSENSE_TUNER_EN */
-
 /* [] END OF FILE */
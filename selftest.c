@@ -0,0 +1,198 @@
+/*******************************************************************************
+* File Name: selftest.c
+*
+* Description: This file contains the sensor self-test. Each sensor is checked
+*              for pin shorts and its electrode capacitance is compared with the
+*              limits in sensor_table.c, within a configurable time budget.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "selftest.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define FF_PER_PF           (1000u)
+
+/* One bit per sensor in selftestFailMask */
+#if (SENSOR_COUNT > 16u)
+#error "selftestFailMask holds up to 16 sensors"
+#endif
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Names of the results, in result order */
+static const char * const selftestName[] = {"PASS", "SHORT", "LOW", "HIGH", "ERROR", "SKIPPED"};
+
+/* Bit n is set if sensor n failed the last self-test */
+static uint16_t selftestFailMask = 0u;
+
+
+/*******************************************************************************
+* Function Name: selftest_run
+********************************************************************************
+* Summary:
+*  This function tests every sensor in turn and reports one CSV row per
+*  sensor, then a summary:
+*    Sensor,CapPf,MinPf,MaxPf,Result
+*    SelfTest=PASS|FAIL|INCOMPLETE Passed=N/12 TimeMs=T
+*  A sensor is only started if the time used so far plus the longest test so
+*  far stays within the budget; the rest are skipped. The report is printed
+*  after the last test, so that UART output does not count against the
+*  budget. It must be called while no scan is in progress.
+*
+* Parameters:
+*    budgetMs    Time the tests may take in ms.
+*
+* Return:
+*  TRUE if every sensor passed, FALSE otherwise.
+*
+*******************************************************************************/
+uint8_t selftest_run(uint32_t budgetMs)
+{
+    uint8_t result[NUMSENSORS];
+    uint32_t capFf[NUMSENSORS];
+    uint32_t start = hal_time_ms();
+    uint32_t longest = 0u;
+    uint32_t elapsed = 0u;
+    uint8_t passed = 0u;
+    uint8_t skipped = 0u;
+
+    selftestFailMask = 0u;
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        uint32_t testStart = hal_time_ms();
+
+        capFf[i] = 0u;
+        if(((testStart - start) + longest) > budgetMs)
+        {
+            result[i] = SELFTEST_SKIPPED;
+            skipped++;
+            continue;
+        }
+
+        switch(hal_sensor_self_test(i, &capFf[i]))
+        {
+            case HAL_SELFTEST_PASS:
+                if(capFf[i] < ((uint32_t)sensorCapMinPf[i] * FF_PER_PF))
+                {
+                    result[i] = SELFTEST_LOW;
+                }
+                else if(capFf[i] > ((uint32_t)sensorCapMaxPf[i] * FF_PER_PF))
+                {
+                    result[i] = SELFTEST_HIGH;
+                }
+                else
+                {
+                    result[i] = SELFTEST_PASS;
+                }
+                break;
+            case HAL_SELFTEST_SHORT:
+                result[i] = SELFTEST_SHORT;
+                break;
+            default:
+                result[i] = SELFTEST_ERROR;
+                break;
+        }
+        if(result[i] == SELFTEST_PASS)
+        {
+            passed++;
+        }
+        else
+        {
+            selftestFailMask |= (uint16_t)(1u << i);
+        }
+
+        if((hal_time_ms() - testStart) > longest)
+        {
+            longest = hal_time_ms() - testStart;
+        }
+    }
+    elapsed = hal_time_ms() - start;
+
+    hal_uart_put_string("Sensor,CapPf,MinPf,MaxPf,Result\r\n");
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        display_decimal_val(i, 0);
+        hal_uart_put_string(",");
+        /* fF to pF with 8 fractional bits */
+        display_decimal_fixed_val((int32_t)((capFf[i] * 256u) / FF_PER_PF), 8, 2);
+        hal_uart_put_string(",");
+        display_decimal_val(sensorCapMinPf[i], 0);
+        hal_uart_put_string(",");
+        display_decimal_val(sensorCapMaxPf[i], 0);
+        hal_uart_put_string(",");
+        hal_uart_put_string(selftestName[result[i]]);
+        hal_uart_put_string("\r\n");
+    }
+
+    hal_uart_put_string("SelfTest=");
+    if(selftestFailMask != 0u)
+    {
+        hal_uart_put_string("FAIL");
+    }
+    else
+    {
+        hal_uart_put_string((skipped != 0u) ? "INCOMPLETE" : "PASS");
+    }
+    hal_uart_put_string(" Passed=");
+    display_decimal_val(passed, 0);
+    hal_uart_put_string("/");
+    display_decimal_val(NUMSENSORS, 0);
+    hal_uart_put_string(" TimeMs=");
+    display_decimal_val((int32_t)elapsed, 0);
+    hal_uart_put_string("\r\n\n");
+
+    return (passed == NUMSENSORS) ? TRUE : FALSE;
+}
+
+/*******************************************************************************
+* Function Name: selftest_get_fail_mask
+********************************************************************************
+* Summary:
+*  This function returns the sensors that failed the last self-test, bit n
+*  for sensor n. Skipped sensors are not included.
+*
+*******************************************************************************/
+uint16_t selftest_get_fail_mask(void)
+{
+    return selftestFailMask;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,76 @@
+/*******************************************************************************
+* File Name: selftest.h
+*
+* Description: This file is the public interface of selftest.c source file.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef SOURCE_SELFTEST_H_
+#define SOURCE_SELFTEST_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Time in ms the power-on self-test may add to the startup. Sensors that no
+ * longer fit are skipped. Can also be set from the Makefile:
+ * DEFINES=SELFTEST_BUDGET_MS=50
+ */
+#ifndef SELFTEST_BUDGET_MS
+#define SELFTEST_BUDGET_MS          (100u)
+#endif
+
+/* Result of each sensor */
+#define SELFTEST_PASS               (0u)
+#define SELFTEST_SHORT              (1u)    /* Pin shorted to a supply or another pin */
+#define SELFTEST_LOW                (2u)    /* Capacitance below sensorCapMinPf[] */
+#define SELFTEST_HIGH               (3u)    /* Capacitance above sensorCapMaxPf[] */
+#define SELFTEST_ERROR              (4u)    /* Test could not run */
+#define SELFTEST_SKIPPED            (5u)    /* Not tested within the time budget */
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+uint8_t selftest_run(uint32_t budgetMs);
+uint16_t selftest_get_fail_mask(void);
+
+#endif /* SOURCE_SELFTEST_H_ */
+
+
+/* [] END OF FILE  */
@@ -0,0 +1,152 @@
+/*******************************************************************************
+* File Name: sensor_table.c
+*
+* Description: Sensor metadata of the liquid level probe.
+*              Generated by host/gen_sensor_table.py from design.cycapsense.
+*              Do not edit; run make -C host gen after changing the design.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "sensor_table.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* CAPSENSE widget id of each sensor */
+const uint8_t sensorWidgetId[SENSOR_COUNT] =
+{
+    0u,      /* Button0 */
+    1u,      /* Button1 */
+    2u,      /* Button2 */
+    3u,      /* Button3 */
+    4u,      /* Button4 */
+    5u,      /* Button5 */
+    6u,      /* Button6 */
+    7u,      /* Button7 */
+    8u,      /* Button8 */
+    9u,      /* Button9 */
+    10u,     /* Button10 */
+    11u,     /* Button11 */
+};
+
+/* Sensor height in half middle sensor heights */
+const uint8_t sensorHeightUnits[SENSOR_COUNT] =
+{
+    1u,      /* Button0 */
+    2u,      /* Button1 */
+    2u,      /* Button2 */
+    2u,      /* Button3 */
+    2u,      /* Button4 */
+    2u,      /* Button5 */
+    2u,      /* Button6 */
+    2u,      /* Button7 */
+    2u,      /* Button8 */
+    2u,      /* Button9 */
+    2u,      /* Button10 */
+    1u,      /* Button11 */
+};
+
+/* Scale to normalize the full scale counts. 0x0100 = 1.0 in fixed precision 8.8 */
+const int16_t sensorScaleDefault[SENSOR_COUNT] =
+{
+    0x01D0,  /* Button0 */
+    0x0100,  /* Button1 */
+    0x0100,  /* Button2 */
+    0x0100,  /* Button3 */
+    0x0100,  /* Button4 */
+    0x0100,  /* Button5 */
+    0x0100,  /* Button6 */
+    0x0100,  /* Button7 */
+    0x0100,  /* Button8 */
+    0x0100,  /* Button9 */
+    0x0100,  /* Button10 */
+    0x01C0,  /* Button11 */
+};
+
+/* Lowest sensor capacitance in pF that passes the self-test */
+const uint8_t sensorCapMinPf[SENSOR_COUNT] =
+{
+    3u,      /* Button0 */
+    5u,      /* Button1 */
+    5u,      /* Button2 */
+    5u,      /* Button3 */
+    5u,      /* Button4 */
+    5u,      /* Button5 */
+    5u,      /* Button6 */
+    5u,      /* Button7 */
+    5u,      /* Button8 */
+    5u,      /* Button9 */
+    5u,      /* Button10 */
+    3u,      /* Button11 */
+};
+
+/* Highest sensor capacitance in pF that passes the self-test */
+const uint8_t sensorCapMaxPf[SENSOR_COUNT] =
+{
+    40u,     /* Button0 */
+    60u,     /* Button1 */
+    60u,     /* Button2 */
+    60u,     /* Button3 */
+    60u,     /* Button4 */
+    60u,     /* Button5 */
+    60u,     /* Button6 */
+    60u,     /* Button7 */
+    60u,     /* Button8 */
+    60u,     /* Button9 */
+    60u,     /* Button10 */
+    40u,     /* Button11 */
+};
+
+/* Submerged height in half middle sensor heights of each wet mask group */
+const uint8_t sensorMaskUnits[SENSOR_MASK_GROUPS][1u << SENSOR_MASK_GROUP_BITS] =
+{
+    /* Button0 to Button5 */
+    {
+         0u,  1u,  2u,  3u,  2u,  3u,  4u,  5u,  2u,  3u,  4u,  5u,  4u,  5u,  6u,  7u,
+         2u,  3u,  4u,  5u,  4u,  5u,  6u,  7u,  4u,  5u,  6u,  7u,  6u,  7u,  8u,  9u,
+         2u,  3u,  4u,  5u,  4u,  5u,  6u,  7u,  4u,  5u,  6u,  7u,  6u,  7u,  8u,  9u,
+         4u,  5u,  6u,  7u,  6u,  7u,  8u,  9u,  6u,  7u,  8u,  9u,  8u,  9u, 10u, 11u,
+    },
+    /* Button6 to Button11 */
+    {
+         0u,  2u,  2u,  4u,  2u,  4u,  4u,  6u,  2u,  4u,  4u,  6u,  4u,  6u,  6u,  8u,
+         2u,  4u,  4u,  6u,  4u,  6u,  6u,  8u,  4u,  6u,  6u,  8u,  6u,  8u,  8u, 10u,
+         1u,  3u,  3u,  5u,  3u,  5u,  5u,  7u,  3u,  5u,  5u,  7u,  5u,  7u,  7u,  9u,
+         3u,  5u,  5u,  7u,  5u,  7u,  7u,  9u,  5u,  7u,  7u,  9u,  7u,  9u,  9u, 11u,
+    },
+};
+
+
+/* [] END OF FILE */
@@ -0,0 +1,78 @@
+/*******************************************************************************
+* File Name: sensor_table.h
+*
+* Description: Sensor metadata of the liquid level probe.
+*              Generated by host/gen_sensor_table.py from design.cycapsense.
+*              Do not edit; run make -C host gen after changing the design.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef SOURCE_SENSOR_TABLE_H_
+#define SOURCE_SENSOR_TABLE_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Number of CAPSENSE widgets, one sensor each, bottom to top */
+#define SENSOR_COUNT                (12u)
+/* Raw count resolution of the widgets */
+#define SENSOR_RESOLUTION_BITS      (10u)
+/* Probe height in half middle sensor heights */
+#define SENSOR_HEIGHT_UNITS         (22u)
+/* The wet sensor mask, bit i for sensor i, is looked up in groups of
+ * SENSOR_MASK_GROUP_BITS bits, group 0 at the bottom
+ */
+#define SENSOR_MASK_GROUP_BITS      (6u)
+#define SENSOR_MASK_GROUPS          (2u)
+
+/*******************************************************************************
+* External variables
+*******************************************************************************/
+extern const uint8_t sensorWidgetId[SENSOR_COUNT];
+extern const uint8_t sensorHeightUnits[SENSOR_COUNT];
+extern const int16_t sensorScaleDefault[SENSOR_COUNT];
+extern const uint8_t sensorCapMinPf[SENSOR_COUNT];
+extern const uint8_t sensorCapMaxPf[SENSOR_COUNT];
+extern const uint8_t sensorMaskUnits[SENSOR_MASK_GROUPS][1u << SENSOR_MASK_GROUP_BITS];
+
+#endif /* SOURCE_SENSOR_TABLE_H_ */
+
+
+/* [] END OF FILE */
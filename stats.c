@@ -0,0 +1,361 @@
+/*******************************************************************************
+* File Name: stats.c
+*
+* Description: This file contains the per-sensor noise statistics. The processed
+*              counts of every frame are accumulated over a window of frames, and
+*              mean, variance, extremes and the signal-to-noise ratio against the
+*              captured wet response are reported on command.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "stats.h"
+
+#include <string.h>
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Accumulators of one sensor over a window. Samples are summed as their
+ * difference to the first sample of the window, so the sums stay small and
+ * the variance is exact however far the mean is from zero.
+ */
+typedef struct
+{
+    int32_t sum;                        /* Sum of sample - shift */
+    uint64_t sumSq;                     /* Sum of (sample - shift)^2 */
+    int16_t shift;                      /* First sample of the window */
+    int16_t min;
+    int16_t max;
+} stats_acc_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int32_t stats_mean(const stats_acc_t *acc, uint16_t count);
+static int16_t stats_sample(uint16_t raw, uint8_t sensor);
+static int32_t stats_scale(int64_t value, uint8_t sensor);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint16_t statsWindow = STATS_WINDOW_DEFAULT;
+
+/* Window being accumulated and the last complete one */
+static stats_acc_t statsRun[NUMSENSORS];
+static uint16_t statsRunCount = 0;
+static stats_acc_t statsDone[NUMSENSORS];
+static uint16_t statsDoneCount = 0;
+
+/* Mean processed count of each sensor when wet, 0 until captured */
+static int16_t statsWet[NUMSENSORS];
+
+
+/*******************************************************************************
+* Function Name: stats_process_frame
+********************************************************************************
+* Summary:
+*  This function adds the difference counts of the current frame to the
+*  running window. When the window is full it becomes the reported one and a
+*  new window starts. The scale is applied when the statistics are read, so
+*  the frame needs no multiply. It must be called once per frame.
+*
+*******************************************************************************/
+void stats_process_frame(void)
+{
+    stats_acc_t *acc = statsRun;
+    const uint16_t *raw;
+    uint8_t stride;
+
+    level_get_raw_source(&raw, &stride);
+    if(statsRunCount == 0u)
+    {
+        for(uint8_t i = 0; i < NUMSENSORS; i++)
+        {
+            int16_t sample = stats_sample(raw[i * stride], i);
+
+            acc[i].sum = 0;
+            acc[i].sumSq = 0u;
+            acc[i].shift = sample;
+            acc[i].min = sample;
+            acc[i].max = sample;
+        }
+    }
+
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        int16_t sample = stats_sample(*raw, i);
+        int32_t delta = (int32_t)sample - acc[i].shift;
+        /* |delta| < 2^16, so its square fits 32 bits */
+        uint32_t magnitude = (uint32_t)((delta < 0) ? -delta : delta);
+
+        acc[i].sum += delta;
+        acc[i].sumSq += magnitude * magnitude;
+        if(sample < acc[i].min)
+        {
+            acc[i].min = sample;
+        }
+        if(sample > acc[i].max)
+        {
+            acc[i].max = sample;
+        }
+        raw += stride;
+    }
+
+    statsRunCount++;
+    if(statsRunCount >= statsWindow)
+    {
+        memcpy(statsDone, statsRun, sizeof(statsDone));
+        statsDoneCount = statsRunCount;
+        statsRunCount = 0u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: stats_clear
+********************************************************************************
+* Summary:
+*  This function discards the running and the last complete window. The wet
+*  response is kept.
+*
+*******************************************************************************/
+void stats_clear(void)
+{
+    statsRunCount = 0u;
+    statsDoneCount = 0u;
+}
+
+/*******************************************************************************
+* Function Name: stats_set_window
+********************************************************************************
+* Summary:
+*  This function sets the number of frames per window and restarts the
+*  statistics.
+*
+* Return:
+*  TRUE if the window is within STATS_WINDOW_MIN..STATS_WINDOW_MAX.
+*
+*******************************************************************************/
+uint8_t stats_set_window(uint32_t frames)
+{
+    if((frames < STATS_WINDOW_MIN) || (frames > STATS_WINDOW_MAX))
+    {
+        return FALSE;
+    }
+    statsWindow = (uint16_t)frames;
+    stats_clear();
+    return TRUE;
+}
+
+/*******************************************************************************
+* Function Name: stats_capture_wet
+********************************************************************************
+* Summary:
+*  This function takes the means of the last complete window as the wet
+*  response of every sensor. Submerge the whole probe and wait one window
+*  before calling it.
+*
+* Return:
+*  TRUE if a complete window was available.
+*
+*******************************************************************************/
+uint8_t stats_capture_wet(void)
+{
+    if(statsDoneCount == 0u)
+    {
+        return FALSE;
+    }
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        /* 24.8 mean, rounded, saturated like the processed counts */
+        int32_t wet = (stats_scale(stats_mean(&statsDone[i], statsDoneCount), i) + 128) >> 8;
+
+        statsWet[i] = (int16_t)((wet > INT16_MAX) ? INT16_MAX : ((wet < INT16_MIN) ? INT16_MIN : wet));
+    }
+    return TRUE;
+}
+
+/*******************************************************************************
+* Function Name: stats_display
+********************************************************************************
+* Summary:
+*  This function prints the statistics of the last complete window, or of
+*  the running one before the first window completes, one CSV row per sensor:
+*    Sensor,N,Mean,Var,Sd,Min,Max,PkPk,Wet,SNR
+*  All values are in processed counts, converted from the difference counts
+*  with the current scale. SNR is the wet response divided by the standard
+*  deviation and is left empty until a wet response has been captured, or if
+*  the sensor shows no noise.
+*
+*******************************************************************************/
+void stats_display(void)
+{
+    const stats_acc_t *acc = (statsDoneCount != 0u) ? statsDone : statsRun;
+    uint16_t count = (statsDoneCount != 0u) ? statsDoneCount : statsRunCount;
+
+    hal_uart_put_string("StatsWindow=");
+    display_decimal_val(statsWindow, 0);
+    hal_uart_put_string("\r\n");
+    if(count == 0u)
+    {
+        hal_uart_put_string("No frames yet\r\n");
+        return;
+    }
+
+    hal_uart_put_string("Sensor,N,Mean,Var,Sd,Min,Max,PkPk,Wet,SNR\r\n");
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        /* count^2 times the variance, never negative */
+        uint64_t spread = (acc[i].sumSq * count) - (uint64_t)((int64_t)acc[i].sum * acc[i].sum);
+        /* Variance and standard deviation with 8 fractional bits, the
+         * variance scaled by the square of the 8.8 scale
+         */
+        uint64_t variance = ((spread / count) << 8) / count;
+        uint64_t scale = (uint64_t)((sensorScale[i] < 0) ? -sensorScale[i] : sensorScale[i]);
+        uint32_t deviation;
+
+        variance = (((variance * scale) >> 8) * scale) >> 8;
+        deviation = stats_sqrt(variance << 8);
+
+        display_decimal_val(i, 0);
+        hal_uart_put_string(",");
+        display_decimal_val(count, 0);
+        hal_uart_put_string(",");
+        display_decimal_fixed_val(stats_scale(stats_mean(&acc[i], count), i), 8, 1);
+        hal_uart_put_string(",");
+        display_decimal_fixed_val((variance > INT32_MAX) ? INT32_MAX : (int32_t)variance, 8, 2);
+        hal_uart_put_string(",");
+        display_decimal_fixed_val((int32_t)deviation, 8, 2);
+        hal_uart_put_string(",");
+        display_decimal_val(stats_scale(acc[i].min, i), 0);
+        hal_uart_put_string(",");
+        display_decimal_val(stats_scale(acc[i].max, i), 0);
+        hal_uart_put_string(",");
+        display_decimal_val(stats_scale(acc[i].max, i) - stats_scale(acc[i].min, i), 0);
+        hal_uart_put_string(",");
+        display_decimal_val(statsWet[i], 0);
+        hal_uart_put_string(",");
+        if((statsWet[i] != 0) && (deviation != 0u))
+        {
+            display_decimal_fixed_val((int32_t)(((int64_t)statsWet[i] << 16) / deviation), 8, 1);
+        }
+        hal_uart_put_string("\r\n");
+    }
+}
+
+/*******************************************************************************
+* Function Name: stats_mean
+********************************************************************************
+* Summary:
+*  This function returns the mean of a window in fixed precision 24.8.
+*
+*******************************************************************************/
+static int32_t stats_mean(const stats_acc_t *acc, uint16_t count)
+{
+    return ((int32_t)acc->shift * 256) + (int32_t)(((int64_t)acc->sum * 256) / count);
+}
+
+/*******************************************************************************
+* Function Name: stats_sample
+********************************************************************************
+* Summary:
+*  This function returns the difference count of a raw count of a sensor,
+*  saturated to the int16_t range as the processed counts are.
+*
+*******************************************************************************/
+static int16_t stats_sample(uint16_t raw, uint8_t sensor)
+{
+    int32_t diff = (int32_t)raw - (int32_t)sensorEmptyOffset[sensor];
+
+    if(diff > INT16_MAX)
+    {
+        diff = INT16_MAX;
+    }
+    else if(diff < INT16_MIN)
+    {
+        diff = INT16_MIN;
+    }
+    return (int16_t)diff;
+}
+
+/*******************************************************************************
+* Function Name: stats_scale
+********************************************************************************
+* Summary:
+*  This function converts a value in difference counts, of any fixed
+*  precision, to processed counts of the same precision with the scale of
+*  the sensor.
+*
+*******************************************************************************/
+static int32_t stats_scale(int64_t value, uint8_t sensor)
+{
+    return (int32_t)((value * sensorScale[sensor]) >> 8);
+}
+
+/*******************************************************************************
+* Function Name: stats_sqrt
+********************************************************************************
+* Summary:
+*  This function returns the integer square root, rounded down.
+*
+*******************************************************************************/
+uint32_t stats_sqrt(uint64_t value)
+{
+    uint64_t root = 0u;
+    uint64_t bit = 1uLL << 62;
+
+    while(bit > value)
+    {
+        bit >>= 2;
+    }
+    while(bit != 0u)
+    {
+        if(value >= (root + bit))
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,409 @@
+/*******************************************************************************
+* File Name: sweep.c
+*
+* Description: This file contains the automated characterization sweep. At
+*              each test point the operator sets the level and presses Enter; the sweep
+*              averages a number of frames for all sensors and, after a rising and a
+*              falling pass, reports error, linearity, hysteresis and resolution.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "sweep.h"
+#include "stats.h"
+
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Rising pass visits every point, the falling pass returns from the one below the top */
+#define SWEEP_STEPS         ((2u * sweepPoints) - 1u)
+
+#define SWEEP_RISE          (0u)
+#define SWEEP_FALL          (1u)
+
+/* Sweep states */
+#define SWEEP_IDLE          (0u)
+#define SWEEP_WAIT          (1u)    /* Waiting for Enter at the next point */
+#define SWEEP_ACQUIRE       (2u)    /* Averaging frames at the current point */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void sweep_prompt(void);
+static void sweep_finish_point(void);
+static void sweep_report(void);
+static uint64_t sweep_spread(int32_t sum, uint64_t sumSq, uint8_t count);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint8_t sweepState = SWEEP_IDLE;
+static uint8_t sweepFrames = SWEEP_FRAMES_DEFAULT;
+static uint8_t sweepStep = 0;
+static uint8_t sweepPoints = 0;        /* Size of the sample table at the start */
+static uint8_t frameCount = 0;
+
+/* Accumulators of the current point */
+static int32_t sumProcessed[NUMSENSORS];
+static uint64_t sumSqProcessed[NUMSENSORS];
+static int32_t sumLevel;
+static uint64_t sumSqLevel;
+
+/* Mean level and level standard deviation per pass and point, both 8.8 mm.
+ * The probe range of LEVELMM_MAX mm bounds both to 16 bits.
+ */
+static uint16_t pointLevel[2][SAMPLE_TABLE_MAX];
+static uint16_t pointDeviation[2][SAMPLE_TABLE_MAX];
+
+
+/*******************************************************************************
+* Function Name: sweep_start
+********************************************************************************
+* Summary:
+*  This function starts a new sweep over the sample table and prompts for the
+*  first test point. The table must not change while the sweep runs.
+*
+* Parameters:
+*    frames    Frames averaged per test point, 0 for SWEEP_FRAMES_DEFAULT.
+*
+*******************************************************************************/
+void sweep_start(uint8_t frames)
+{
+    sweepFrames = (frames == 0u) ? SWEEP_FRAMES_DEFAULT : frames;
+    sweepPoints = numSamples;
+    sweepStep = 0;
+    sweepState = SWEEP_WAIT;
+    uartTxMode = UART_NONE;
+
+    hal_uart_put_string("Sweep of ");
+    display_decimal_val(sweepPoints, 0);
+    hal_uart_put_string(" points, ");
+    display_decimal_val(sweepFrames, 0);
+    hal_uart_put_string(" frames each. 'reset' aborts.\r\n");
+    hal_uart_put_string("Point,Dir,PresetMm,");
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        hal_uart_put_string("Mean");
+        display_decimal_val(i, 0);
+        hal_uart_put_string(",");
+    }
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        hal_uart_put_string("Var");
+        display_decimal_val(i, 0);
+        hal_uart_put_string(",");
+    }
+    hal_uart_put_string("LevelMm,LevelVar\r\n");
+    sweep_prompt();
+}
+
+/*******************************************************************************
+* Function Name: sweep_abort
+********************************************************************************
+* Summary:
+*  This function stops a sweep in progress. Results are discarded.
+*
+*******************************************************************************/
+void sweep_abort(void)
+{
+    if(sweepState != SWEEP_IDLE)
+    {
+        sweepState = SWEEP_IDLE;
+        hal_uart_put_string("Sweep aborted\r\n");
+    }
+}
+
+/*******************************************************************************
+* Function Name: sweep_is_active
+********************************************************************************
+* Summary:
+*  This function returns TRUE while a sweep is in progress.
+*
+*******************************************************************************/
+uint8_t sweep_is_active(void)
+{
+    return (sweepState != SWEEP_IDLE) ? TRUE : FALSE;
+}
+
+/*******************************************************************************
+* Function Name: sweep_trigger
+********************************************************************************
+* Summary:
+*  This function starts averaging at the current test point. It is called
+*  when the operator presses Enter and is ignored while averaging.
+*
+*******************************************************************************/
+void sweep_trigger(void)
+{
+    if(sweepState == SWEEP_WAIT)
+    {
+        memset(sumProcessed, 0, sizeof(sumProcessed));
+        memset(sumSqProcessed, 0, sizeof(sumSqProcessed));
+        sumLevel = 0;
+        sumSqLevel = 0u;
+        frameCount = 0;
+        sweepState = SWEEP_ACQUIRE;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sweep_process_frame
+********************************************************************************
+* Summary:
+*  This function adds the frame just processed by level_process_frame() to
+*  the current test point. It must be called once per frame.
+*
+*******************************************************************************/
+void sweep_process_frame(void)
+{
+    if(sweepState != SWEEP_ACQUIRE)
+    {
+        return;
+    }
+
+    level_require_processed();
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        sumProcessed[i] += sensorProcessed[i];
+        sumSqProcessed[i] += (uint64_t)((int64_t)sensorProcessed[i] * sensorProcessed[i]);
+    }
+    sumLevel += levelMm;
+    sumSqLevel += (uint64_t)((int64_t)levelMm * levelMm);
+
+    frameCount++;
+    if(frameCount >= sweepFrames)
+    {
+        sweep_finish_point();
+    }
+}
+
+/*******************************************************************************
+* Function Name: sweep_prompt
+********************************************************************************
+* Summary:
+*  This function asks the operator to set the level of the current step.
+*
+*******************************************************************************/
+static void sweep_prompt(void)
+{
+    uint8_t point = (sweepStep < sweepPoints) ? sweepStep : (SWEEP_STEPS - 1u - sweepStep);
+
+    hal_uart_put_string("Set ");
+    display_decimal_val(arrayAxisLabel[point], 0);
+    hal_uart_put_string((sweepStep < sweepPoints) ? " mm rising" : " mm falling");
+    hal_uart_put_string(", press Enter\r\n");
+}
+
+/*******************************************************************************
+* Function Name: sweep_finish_point
+********************************************************************************
+* Summary:
+*  This function prints the averages of the current test point, stores its
+*  level statistics and moves to the next step.
+*  Sensor means and variances are in counts and counts^2, level mean in mm and
+*  level variance in mm^2, all with 8 fractional bits.
+*
+*******************************************************************************/
+static void sweep_finish_point(void)
+{
+    uint8_t dir = (sweepStep < sweepPoints) ? SWEEP_RISE : SWEEP_FALL;
+    uint8_t point = (dir == SWEEP_RISE) ? sweepStep : (SWEEP_STEPS - 1u - sweepStep);
+    uint64_t variance;
+
+    display_decimal_val(point, 0);
+    hal_uart_put_string((dir == SWEEP_RISE) ? ",Rise," : ",Fall,");
+    display_decimal_val(arrayAxisLabel[point], 0);
+    hal_uart_put_string(",");
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        display_decimal_fixed_val((int32_t)(((int64_t)sumProcessed[i] * 256) / frameCount), 8, 1);
+        hal_uart_put_string(",");
+    }
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        variance = (sweep_spread(sumProcessed[i], sumSqProcessed[i], frameCount) << 8) /
+                   ((uint32_t)frameCount * frameCount);
+        display_decimal_fixed_val((variance > INT32_MAX) ? INT32_MAX : (int32_t)variance, 8, 1);
+        hal_uart_put_string(",");
+    }
+
+    /* Level is 24.8, so its spread carries 16 fractional bits */
+    variance = sweep_spread(sumLevel, sumSqLevel, frameCount) /
+               (((uint32_t)frameCount * frameCount) << 8);
+    if(variance > (((uint64_t)UINT16_MAX * UINT16_MAX) >> 8))
+    {
+        variance = ((uint64_t)UINT16_MAX * UINT16_MAX) >> 8;
+    }
+    pointLevel[dir][point] = (uint16_t)(sumLevel / frameCount);
+    /* sqrt of a 24.8 value scaled by 256 is again 24.8 */
+    pointDeviation[dir][point] = (uint16_t)stats_sqrt(variance << 8);
+    if(point == (sweepPoints - 1u))
+    {
+        /* The top point is visited once and serves both passes */
+        pointLevel[SWEEP_FALL][point] = pointLevel[SWEEP_RISE][point];
+        pointDeviation[SWEEP_FALL][point] = pointDeviation[SWEEP_RISE][point];
+    }
+    display_decimal_fixed_val(pointLevel[dir][point], 8, 1);
+    hal_uart_put_string(",");
+    display_decimal_fixed_val((int32_t)variance, 8, 2);
+    hal_uart_put_string("\r\n");
+
+    sweepStep++;
+    if(sweepStep < SWEEP_STEPS)
+    {
+        sweepState = SWEEP_WAIT;
+        sweep_prompt();
+    }
+    else
+    {
+        sweepState = SWEEP_IDLE;
+        sweep_report();
+    }
+}
+
+/*******************************************************************************
+* Function Name: sweep_report
+********************************************************************************
+* Summary:
+*  This function prints one row per test point:
+*    PresetMm,RiseMm,FallMm,ErrMm,LinErrMm,HystMm,ResMm
+*  ErrMm is the mean of both passes minus the preset, limited to the probe
+*  range. LinErrMm is the mean minus the least squares line through the
+*  points inside the probe range. HystMm is rising minus falling. ResMm is
+*  the larger standard deviation of the two passes, the smallest level change
+*  that stands out from the noise. A summary with the largest linearity error
+*  in percent of full scale and the largest hysteresis follows.
+*
+*******************************************************************************/
+static void sweep_report(void)
+{
+    int64_t n = 0;
+    int64_t sumX = 0;
+    int64_t sumY = 0;
+    int64_t sumXX = 0;
+    int64_t sumXY = 0;
+    int64_t num;
+    int64_t den;
+    int32_t maxLinErr = 0;
+    int32_t maxHyst = 0;
+
+    /* Least squares fit of the mean level over the points inside the probe range */
+    for(uint8_t p = 0; p < sweepPoints; p++)
+    {
+        int32_t x = arrayAxisLabel[p];
+        int32_t y = (pointLevel[SWEEP_RISE][p] + pointLevel[SWEEP_FALL][p]) / 2;
+
+        if((x >= 0) && (x <= (int32_t)LEVELMM_MAX))
+        {
+            n++;
+            sumX += x;
+            sumY += y;
+            sumXX += (int64_t)x * x;
+            sumXY += (int64_t)x * y;
+        }
+    }
+    num = (n * sumXY) - (sumX * sumY);
+    den = (n * sumXX) - (sumX * sumX);
+
+    hal_uart_put_string("PresetMm,RiseMm,FallMm,ErrMm,LinErrMm,HystMm,ResMm\r\n");
+    for(uint8_t p = 0; p < sweepPoints; p++)
+    {
+        int32_t x = arrayAxisLabel[p];
+        int32_t y = (pointLevel[SWEEP_RISE][p] + pointLevel[SWEEP_FALL][p]) / 2;
+        int32_t expected = (x < 0) ? 0 : ((x > (int32_t)LEVELMM_MAX) ? (int32_t)LEVELMM_MAX : x);
+        int32_t hyst = pointLevel[SWEEP_RISE][p] - pointLevel[SWEEP_FALL][p];
+        int32_t deviation = pointDeviation[SWEEP_RISE][p];
+        int32_t linErr = 0;
+
+        if(pointDeviation[SWEEP_FALL][p] > deviation)
+        {
+            deviation = pointDeviation[SWEEP_FALL][p];
+        }
+        if((den != 0) && (x >= 0) && (x <= (int32_t)LEVELMM_MAX))
+        {
+            linErr = y - (int32_t)(((sumY * den) + (num * ((n * x) - sumX))) / (n * den));
+            if(((linErr < 0) ? -linErr : linErr) > maxLinErr)
+            {
+                maxLinErr = (linErr < 0) ? -linErr : linErr;
+            }
+        }
+        if(((hyst < 0) ? -hyst : hyst) > maxHyst)
+        {
+            maxHyst = (hyst < 0) ? -hyst : hyst;
+        }
+
+        display_decimal_val(x, 0);
+        hal_uart_put_string(",");
+        display_decimal_fixed_val(pointLevel[SWEEP_RISE][p], 8, 1);
+        hal_uart_put_string(",");
+        display_decimal_fixed_val(pointLevel[SWEEP_FALL][p], 8, 1);
+        hal_uart_put_string(",");
+        display_decimal_fixed_val(y - (expected << 8), 8, 1);
+        hal_uart_put_string(",");
+        display_decimal_fixed_val(linErr, 8, 2);
+        hal_uart_put_string(",");
+        display_decimal_fixed_val(hyst, 8, 1);
+        hal_uart_put_string(",");
+        display_decimal_fixed_val(deviation, 8, 2);
+        hal_uart_put_string("\r\n");
+    }
+
+    hal_uart_put_string("MaxLinErr%FS=");
+    display_decimal_fixed_val((maxLinErr * 100) / (int32_t)LEVELMM_MAX, 8, 2);
+    hal_uart_put_string("   MaxHystMm=");
+    display_decimal_fixed_val(maxHyst, 8, 1);
+    hal_uart_put_string("\r\nSweep done\r\n");
+}
+
+/*******************************************************************************
+* Function Name: sweep_spread
+********************************************************************************
+* Summary:
+*  This function returns count^2 times the variance of count samples, given
+*  their sum and sum of squares.
+*
+*******************************************************************************/
+static uint64_t sweep_spread(int32_t sum, uint64_t sumSq, uint8_t count)
+{
+    /* Never negative: count * sumSq >= sum^2 for any set of samples */
+    return (sumSq * count) - (uint64_t)((int64_t)sum * sum);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,174 @@
+/*******************************************************************************
+* File Name: tilt.c
+*
+* Description: This file contains the tilt-aware level estimate. The graded
+*              responses of the partially wet sensors give the mean surface height
+*              on the probe, and their spread indicates the surface tilt.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "tilt.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define TILT_SPAN               (TILT_WET_RESPONSE - TILT_DRY_RESPONSE)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Mean surface height on the probe. Fixed precision 24.8 */
+int32_t tiltLevelMm = 0;
+/* Height over which the surface spreads beyond one sensor. Fixed precision
+ * 24.8. 0 for a level surface.
+ */
+int32_t tiltSpreadMm = 0;
+/* TRUE to report tiltLevelMm as the level */
+uint8_t tiltEnable = FALSE;
+/* TRUE while tilt is enabled and the estimate follows the frames */
+static uint8_t tiltTracking = FALSE;
+
+
+/*******************************************************************************
+* Function Name: tilt_estimate
+********************************************************************************
+* Summary:
+*  This function estimates the level from the graded sensor responses of the
+*  frame just processed. Each sensor adds its height times its wet fraction,
+*  so a surface that crosses several sensors at a slant gives its mean
+*  height, where the submerged count of level_count_submerged() depends on
+*  which of the partial sensors pass the threshold. The spread is the height
+*  from the bottom of the lowest to the top of the highest partially wet
+*  sensor, less one middle sensor, which a level surface can fill partly on
+*  its own.
+*  The processed counts are computed if the frame has not needed them yet.
+*
+*******************************************************************************/
+void tilt_estimate(void)
+{
+    int32_t wet = 0;
+    uint8_t units = 0;
+    uint8_t bottom = 0;
+    uint8_t top = 0;
+
+    level_require_processed();
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        int32_t response = (int32_t)sensorProcessed[i] - TILT_DRY_RESPONSE;
+
+        if(response > 0)
+        {
+            wet += ((response < TILT_SPAN) ? response : TILT_SPAN) * sensorHeightUnits[i];
+        }
+        if((sensorProcessed[i] > TILT_PARTIAL_LOW) && (sensorProcessed[i] < TILT_PARTIAL_HIGH))
+        {
+            if(top == 0u)
+            {
+                bottom = units;
+            }
+            top = units + sensorHeightUnits[i];
+        }
+        units += sensorHeightUnits[i];
+    }
+
+    tiltLevelMm = (wet * (sensorHeight >> 1)) / TILT_SPAN;
+    if(tiltLevelMm > ((int32_t)LEVELMM_MAX << 8) - (sensorHeight >> 2))
+    {
+        tiltLevelMm = LEVELMM_MAX << 8;
+    }
+    tiltSpreadMm = ((int32_t)(top - bottom) * (sensorHeight >> 1)) - sensorHeight;
+    if(tiltSpreadMm < 0)
+    {
+        tiltSpreadMm = 0;
+    }
+}
+
+/*******************************************************************************
+* Function Name: tilt_process_frame
+********************************************************************************
+* Summary:
+*  This function replaces levelMm and levelPercent by the tilt-aware estimate
+*  when tilt is enabled. With tilt off the frame is left alone, so that the
+*  processed counts are not computed for it; tilt_display() estimates on
+*  demand. The estimate is kept for a frame in which lazy mode found no
+*  sensor changed. The cost is a few operations per sensor and one division
+*  per frame.
+*
+*******************************************************************************/
+void tilt_process_frame(void)
+{
+    if(tiltEnable == TRUE)
+    {
+        if((levelFrameChanged == TRUE) || (tiltTracking == FALSE))
+        {
+            tilt_estimate();
+            tiltTracking = TRUE;
+        }
+        levelMm = tiltLevelMm;
+        levelPercent = (levelMm * 100) / LEVELMM_MAX;
+    }
+    else
+    {
+        tiltTracking = FALSE;
+    }
+}
+
+/*******************************************************************************
+* Function Name: tilt_display
+********************************************************************************
+* Summary:
+*  This function displays the tilt-aware level, the spread and whether the
+*  level reports the estimate.
+*
+*******************************************************************************/
+void tilt_display(void)
+{
+    if(tiltEnable == FALSE)
+    {
+        tilt_estimate();
+    }
+    hal_uart_put_string("Tilt=");
+    hal_uart_put_string((tiltEnable == TRUE) ? "on" : "off");
+    hal_uart_put_string(" TiltMm=");
+    display_decimal_fixed_val(tiltLevelMm, 8, 1);
+    hal_uart_put_string(" SpreadMm=");
+    display_decimal_fixed_val(tiltSpreadMm, 8, 1);
+    hal_uart_put_string("\r\n");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,80 @@
+/*******************************************************************************
+* File Name: tilt.h
+*
+* Description: This file is the public interface of tilt.c source file.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef SOURCE_TILT_H_
+#define SOURCE_TILT_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Processed counts at which a sensor starts to count as wet and counts as
+ * fully wet. The band between them is mapped linearly to its wet fraction.
+ */
+#define TILT_DRY_RESPONSE           (SENSORFULL / 8)
+#define TILT_WET_RESPONSE           (SENSORFULL - (SENSORFULL / 8))
+
+/* Band in which a sensor counts as partially wet for the spread. It leaves
+ * room for the scale and gain errors of dry and full sensors.
+ */
+#define TILT_PARTIAL_LOW            (SENSORFULL / 4)
+#define TILT_PARTIAL_HIGH           (SENSORFULL - (SENSORFULL / 4))
+
+/*******************************************************************************
+* External variables
+*******************************************************************************/
+extern int32_t tiltLevelMm;
+extern int32_t tiltSpreadMm;
+extern uint8_t tiltEnable;
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void tilt_estimate(void);
+void tilt_process_frame(void);
+void tilt_display(void);
+
+#endif /* SOURCE_TILT_H_ */
+
+
+/* [] END OF FILE  */
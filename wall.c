@@ -0,0 +1,201 @@
+/*******************************************************************************
+* File Name: wall.c
+*
+* Description: This file contains the container wall compensation. The wet
+*              response of each sensor is modelled through the configured wall
+*              and the default scales are corrected for the difference to the
+*              reference wall.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hal.h"
+#include "level.h"
+#include "interface.h"
+#include "alarm.h"
+#include "liquid.h"
+#include "wall.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Seed of the configuration checksum, so that erased storage is rejected */
+#define WALL_CONFIG_CHECK       (0x3A11u)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint16_t wall_config_check(const wall_config_t *config);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+int16_t wallScale[NUMSENSORS];
+
+static wall_config_t wallConfig = {WALL_REF_THICKNESS, WALL_REF_PERMITTIVITY, 0u};
+
+
+/*******************************************************************************
+* Function Name: wall_config_check
+********************************************************************************
+* Summary:
+*  This function computes the checksum of a wall configuration.
+*
+*******************************************************************************/
+static uint16_t wall_config_check(const wall_config_t *config)
+{
+    return (uint16_t)(WALL_CONFIG_CHECK + ((uint16_t)config->permittivity << 8) + config->thickness);
+}
+
+/*******************************************************************************
+* Function Name: wall_init
+********************************************************************************
+* Summary:
+*  This function loads the stored wall, or the reference wall, and computes
+*  the compensated scales. The liquid class applies them.
+*
+*******************************************************************************/
+void wall_init(void)
+{
+    wall_config_t config;
+    uint32_t storage_status;
+
+    storage_status = hal_storage_read(WALL_CONFIG_START, &config, WALL_CONFIG_SIZE);
+    handle_error(storage_status, "Emulated EEPROM Read failed \r\n");
+
+    if((config.check == wall_config_check(&config)) &&
+       (config.thickness >= WALL_THICKNESS_MIN) && (config.thickness <= WALL_THICKNESS_MAX) &&
+       (config.permittivity >= WALL_PERMITTIVITY_MIN) && (config.permittivity <= WALL_PERMITTIVITY_MAX))
+    {
+        wallConfig = config;
+    }
+    wall_compute_scales(wallConfig.thickness, wallConfig.permittivity, wallScale);
+}
+
+/*******************************************************************************
+* Function Name: wall_compute_scales
+********************************************************************************
+* Summary:
+*  This function computes the default scales corrected for a wall. The wall
+*  is in series with the liquid, and the part of the field of an electrode
+*  that reaches through it is modelled as
+*    w = eps * d / (eps * d + t)
+*  with the permittivity eps and thickness t of the wall and the field depth
+*  d of the electrode. Each scale is multiplied by w of the reference wall
+*  over w of the given wall, so the reference wall leaves it unchanged.
+*
+* Parameters:
+*    thickness       Wall thickness in 0.1 mm.
+*    permittivity    Wall relative permittivity in 0.1.
+*    scale           Receives NUMSENSORS scales in 8.8.
+*
+*******************************************************************************/
+void wall_compute_scales(uint8_t thickness, uint8_t permittivity, int16_t *scale)
+{
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        uint32_t depth = (uint32_t)WALL_DEPTH_PER_UNIT * sensorHeightUnits[i];
+        /* gain = wRef / w = epsRef * (eps * d + t) / ((epsRef * d + tRef) * eps) */
+        uint32_t num = WALL_REF_PERMITTIVITY * ((permittivity * depth) + (10u * thickness));
+        uint32_t den = ((WALL_REF_PERMITTIVITY * depth) + (10u * WALL_REF_THICKNESS)) * permittivity;
+        int32_t value = (int32_t)((((uint64_t)num * (uint16_t)sensorScaleDefault[i]) + (den / 2u)) / den);
+
+        scale[i] = (value > INT16_MAX) ? INT16_MAX : (int16_t)value;
+    }
+}
+
+/*******************************************************************************
+* Function Name: wall_set
+********************************************************************************
+* Summary:
+*  This function sets, stores and applies the wall.
+*
+* Parameters:
+*    thickness       Wall thickness in 0.1 mm.
+*    permittivity    Wall relative permittivity in 0.1.
+*
+* Return:
+*  TRUE if the wall is in range, FALSE otherwise.
+*
+*******************************************************************************/
+uint8_t wall_set(uint32_t thickness, uint32_t permittivity)
+{
+    uint32_t storage_status;
+
+    if((thickness < WALL_THICKNESS_MIN) || (thickness > WALL_THICKNESS_MAX) ||
+       (permittivity < WALL_PERMITTIVITY_MIN) || (permittivity > WALL_PERMITTIVITY_MAX))
+    {
+        return FALSE;
+    }
+    wallConfig.thickness = (uint8_t)thickness;
+    wallConfig.permittivity = (uint8_t)permittivity;
+    wallConfig.check = wall_config_check(&wallConfig);
+    storage_status = hal_storage_write(WALL_CONFIG_START, &wallConfig, WALL_CONFIG_SIZE);
+    handle_error(storage_status, "Emulated EEPROM Write failed \r\n");
+
+    wall_compute_scales(wallConfig.thickness, wallConfig.permittivity, wallScale);
+    liquid_apply();
+    return TRUE;
+}
+
+/*******************************************************************************
+* Function Name: wall_display
+********************************************************************************
+* Summary:
+*  This function displays the wall and, per sensor, the gain over the default
+*  scale, the scale in use and the raw count difference at which the sensor
+*  counts as submerged.
+*
+*******************************************************************************/
+void wall_display(void)
+{
+    hal_uart_put_string("Wall Mm=");
+    display_decimal_fixed_val(((int32_t)wallConfig.thickness * 256 + 5) / 10, 8, 1);
+    hal_uart_put_string(" Eps=");
+    display_decimal_fixed_val(((int32_t)wallConfig.permittivity * 256 + 5) / 10, 8, 1);
+    hal_uart_put_string("\r\nSensor,Gain,Scale,RawLimit\r\n");
+    for(uint8_t i = 0; i < NUMSENSORS; i++)
+    {
+        display_decimal_val(i, 0);
+        hal_uart_put_string(",");
+        display_decimal_fixed_val((int32_t)wallScale[i] * 256 / sensorScaleDefault[i], 8, 2);
+        hal_uart_put_string(",");
+        display_decimal_val(sensorScale[i], 0);
+        hal_uart_put_string(",");
+        display_decimal_val((((int32_t)sensorLimit + 1) * 256 + sensorScale[i] - 1) / sensorScale[i], 0);
+        hal_uart_put_string("\r\n");
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,98 @@
+/*******************************************************************************
+* File Name: wall.h
+*
+* Description: This file is the public interface of wall.c source file.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include guard
+ ******************************************************************************/
+#ifndef SOURCE_WALL_H_
+#define SOURCE_WALL_H_
+
+#include <stdint.h>
+#include "level.h"
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Wall the default scales are tuned for, in 0.1 mm and 0.1 permittivity */
+#define WALL_REF_THICKNESS          (20u)
+#define WALL_REF_PERMITTIVITY       (30u)
+
+/* Depth in 0.1 mm that the field of an electrode reaches per half sensor
+ * unit of its height. Smaller electrodes lose more through a thick wall.
+ */
+#define WALL_DEPTH_PER_UNIT         (15u)
+
+/* Setting ranges */
+#define WALL_THICKNESS_MIN          (1u)
+#define WALL_THICKNESS_MAX          (250u)
+#define WALL_PERMITTIVITY_MIN       (10u)
+#define WALL_PERMITTIVITY_MAX       (250u)
+
+/* Wall configuration, stored after the liquid configuration */
+#define WALL_CONFIG_SIZE            (sizeof(wall_config_t))
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Wall configuration as stored in Emulated EEPROM */
+typedef struct
+{
+    uint8_t thickness;                      /* 0.1 mm */
+    uint8_t permittivity;                   /* 0.1, relative */
+    uint16_t check;                         /* WALL_CONFIG_CHECK plus the bytes above */
+} wall_config_t;
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Default scales compensated for the configured wall */
+extern int16_t wallScale[NUMSENSORS];
+
+/*******************************************************************************
+ * Function prototype
+ ******************************************************************************/
+void wall_init(void);
+void wall_compute_scales(uint8_t thickness, uint8_t permittivity, int16_t *scale);
+uint8_t wall_set(uint32_t thickness, uint32_t permittivity);
+void wall_display(void);
+
+#endif /* SOURCE_WALL_H_ */
+
+
+/* [] END OF FILE  */